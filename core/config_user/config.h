@@ -65,6 +65,7 @@
 #define CMD_SAFETY_DOOR 0x84
 #define CMD_JOG_CANCEL  0x85
 #define CMD_DEBUG_REPORT 0x86 // Only when DEBUG enabled, sends debug report in '{}' braces.
+#define CMD_STATUS_REPORT_BINARY 0x87 // Only when REPORT_BINARY_STATUS enabled, sends binary status frame.
 #define CMD_FEED_OVR_RESET 0x90         // Restores feed override value to 100%.
 #define CMD_FEED_OVR_COARSE_PLUS 0x91
 #define CMD_FEED_OVR_COARSE_MINUS 0x92
@@ -441,6 +442,30 @@
 // machines, perhaps to 0.1mm/min, but your success may vary based on multiple factors.
 #define MINIMUM_FEED_RATE 1.0 // (mm/min)
 
+// Selects the junction speed model of the planner. By default, the maximum cornering speed follows
+// from the centripetal acceleration approximation driven by the single $11 junction deviation and
+// the acceleration limit blended over the junction direction. With this option, the cornering speed
+// is instead limited such that no axis changes its velocity by more than its $14x setting (mm/min)
+// at the junction, like the classic "jerk" settings of other firmwares. The per-axis limits often
+// allow faster cornering on machines with one light and one heavy axis. A $14x value of zero forces
+// that axis to a stop on any change of its velocity.
+// #define JUNCTION_JERK_MODEL // Default disabled. Uncomment to enable.
+
+// Uses a bit-level initial guess refined by two Newton-Raphson steps for the planner reciprocal
+// square roots (block length, junction vector and junction half angle), instead of the FPU divide
+// and sqrtf(). The relative error is below 5e-6, far under the step resolution of any realistic
+// machine. Mostly helps cores without a hardware square root or when streaming many short segments.
+#define FAST_INV_SQRT // Default enabled. Comment to disable.
+
+// Executes G0 rapids non-coordinated. Rather than one straight line limited by the slowest axis in
+// the move direction, the rapid is split into up to N_AXIS line motions, within each of them every
+// axis still moving travels at its own maximum rate. Axes are synchronized only where one of them
+// reaches its target. The path of a rapid is then no longer a straight line, but always stays in the
+// box spanned by the start and target positions, which is checked against soft limits up front.
+// NOTE: Jogging, homing and parking motions are never split. Make sure fixtures and clamps are not
+// in the way of the dog-leg path before enabling this.
+// #define RAPID_NON_COORDINATED // Default disabled. Uncomment to enable.
+
 // Number of arc generation iterations by small angle approximation before exact arc trajectory
 // correction with expensive sin() and cos() calcualtions. This parameter maybe decreased if there
 // are issues with the accuracy of the arc generations, or increased if arc execution is getting
@@ -464,6 +489,12 @@
 // time step. Also, keep in mind that the Arduino delay timer is not very accurate for long delays.
 #define DWELL_TIME_STEP 50 // Integer (1-255) (milliseconds)
 
+// Distance kept above the bottom of the previous peck by the G83 and G73 peck drilling cycles. G83
+// rapids back down to this distance above the last depth after its full retract to R, and G73 backs
+// off by this distance after each peck to break the chip. Increase it for long chips or for drills
+// that need a larger approach at feed rate.
+#define CANNED_CYCLE_PECK_CLEARANCE 0.254 // Float (mm)
+
 // Creates a delay between the direction pin setting and corresponding step pulse by creating
 // another interrupt (Timer2 compare) to manage it. The main Grbl interrupt (Timer1 compare)
 // sets the direction pins, and does not immediately set the stepper pins, as it would in
@@ -510,8 +541,90 @@
 // 115200 baud will take 5 msec to transmit a typical 55 character report. Worst case reports are
 // around 90-100 characters. As long as the serial TX buffer doesn't get continually maxed, Grbl
 // will continue operating efficiently. Size the TX buffer around the size of a worst-case report.
-// #define RX_BUFFER_SIZE 128 // (1-254) Uncomment to override defaults in serial.h
-// #define TX_BUFFER_SIZE 100 // (1-254)
+// NOTE: Both buffers use 16-bit indices and may be sized into the kilobytes for high baud rate or USB
+// links, where a deep receive buffer absorbs host side jitter. The true RX size is reported in the
+// build info and the Bf: status report field, so character counting hosts can use all of it.
+// #define RX_BUFFER_SIZE 128 // (1-65534) Uncomment to override defaults in serial.h
+// #define TX_BUFFER_SIZE 100 // (1-65534)
+
+// Number of independent serial command channels, like a second UART, a USB CDC port, a pendant or
+// a debug port next to the main host link. Each channel has its own RX and TX buffers of the sizes
+// above and its own line assembly, so a pendant polling status or sending commands no longer shares
+// the buffer of the program stream. Realtime commands are accepted from every channel. Channel 0 is
+// the main program stream: it is read first, as long as it has data, and only it takes binary motion
+// frames and checksummed lines. The other channels get one line per main loop pass. Responses go to
+// the channel the line came from, status reports to the requesting channels and alarms and pushed
+// reports to all channels. Platforms feed the additional channels through the channel RX/TX HAL
+// callbacks, see hal_abstract.h.
+// NOTE: All channels share the one g-code parser state. Lines from several channels are executed
+// one at a time, in the order they are read.
+// #define SERIAL_CHANNELS 2 // (1-8) Uncomment to override default in serial.h
+
+// Enables a framed binary motion protocol next to text g-code. A frame carries a pre-parsed line
+// motion (machine coordinate target in mm or steps, feed, spindle speed, condition flags and line
+// number) with a CRC and goes straight to the motion control, bypassing line assembly and the g-code
+// parser. Each frame is answered with 'ok' or 'error:' like a text line, so the usual streaming
+// protocols apply. Modal state (spindle, coolant, offsets) is still set by text g-code and the
+// parser position follows the binary targets. See binary_protocol.h for the frame layout.
+// #define BINARY_MOTION_PROTOCOL // Default disabled. Uncomment to enable.
+
+// Enables a compact binary status frame, sent upon the CMD_STATUS_REPORT_BINARY realtime command.
+// The frame has a fixed layout with the machine position in steps, state and suspend bits, buffer
+// availability, override values and pin states, and is protected by a CRC. It costs a fraction of
+// the text status report in both CPU time and link bandwidth, for hosts polling at high rates.
+// See report.h for the frame layout.
+// #define REPORT_BINARY_STATUS // Default disabled. Uncomment to enable.
+
+// Enables checksummed streaming. A g-code line starting with an N line number must end with '*' and
+// the decimal XOR checksum of all line characters before the '*', as sent. Numbered lines must
+// arrive in sequence. Upon a bad checksum or a missing line, Grbl pushes a [RS:n] resend request
+// once and rejects all lines until line n arrives again. Lines already executed are acknowledged
+// but not executed again, and line N0 always starts a new sequence. Lines without line number are
+// executed as usual. With guaranteed integrity, hosts may stream with deep RX buffers over noisy
+// links. NOTE: '*' must not be used within comments of numbered lines.
+// #define LINE_CHECKSUM_PROTOCOL // Default disabled. Uncomment to enable.
+
+// Enables O-word subroutines and loops of the program stream: O<n> SUB/ENDSUB, O<n> CALL,
+// O<n> REPEAT [count]/ENDREPEAT and O<n> WHILE [value]/ENDWHILE. Body lines are checked for word
+// syntax and stored as pre-parsed words in a RAM cache, so called subroutines and repeated bodies
+// run without being sent or parsed again. Each body line is acknowledged when stored, and the end
+// line when the body has run. See oword.h for the syntax and limits.
+// #define OWORD_SUBROUTINES // Default disabled. Uncomment to enable.
+// #define OWORD_CACHE_SIZE 2048 // (256-65535) Uncomment to override default in oword.h
+
+// Enables local program storage on the block storage HAL (ngrbl_hal_storage_ functions). A program
+// is received once with $F=name and runs with $RUN=name through the same line processing as the
+// program stream, read block by block ahead of execution instead of from the serial buffer. Jobs
+// then run without depending on the streaming latency or link stability of the host. Requires a
+// port providing storage, otherwise the commands fail with a storage error.
+// #define PROGRAM_STORE // Default disabled. Uncomment to enable.
+
+// Enables parametric g-code: numbered parameters #1 to #99 set by #n=value, and bracketed
+// expressions with operators and functions wherever a word takes a number, as X[#1*2] or
+// O1 WHILE [#2 LT 10]. Expressions are compiled once into a compact stack code, so O-word bodies
+// stored with OWORD_SUBROUTINES are evaluated again on each run without being parsed again. '/' is
+// division within a line and block delete only as its first character. NOTE: Numbered lines of
+// LINE_CHECKSUM_PROTOCOL end at the first '*', so their expressions must not use '*' or '**'. See
+// expression.h for the syntax.
+// #define PARAMETRIC_GCODE // Default disabled. Uncomment to enable.
+// #define EXPR_PARAMETERS 100 // (1-256) Uncomment to override default in expression.h
+
+// Enables validation of whole jobs in check mode, faster than checking them line by line with $C.
+// $C=name validates a program of PROGRAM_STORE as fast as its lines parse, and the binary motion
+// protocol validates the line frames sent between a validation begin and end frame. Failing lines
+// do not stop the job, they are logged by line with their status. The summary also reports the
+// extents of the motions and the motions beyond the soft limits. The parser state is restored
+// afterwards. See validation.h.
+// #define PROGRAM_VALIDATION // Default disabled. Uncomment to enable.
+// #define VALIDATION_ERROR_LOG 8 // (1-255) Uncomment to override default in validation.h
+
+// Enables the simulation of stored programs with $SIM=name, to estimate their run time. The program
+// is validated as with $C=name, its motions are also planned and prepared into step segments as in
+// a run with the current overrides. Instead of waiting for the stepper interrupt, the segments are
+// taken at once and their step counts and step timing add up to the exact time the steps would
+// take. The run time of each line and of the program is reported. Requires PROGRAM_STORE and
+// PROGRAM_VALIDATION.
+// #define PROGRAM_SIMULATION // Default disabled. Uncomment to enable.
 
 // A simple software debouncing feature for hard limit switches. When enabled, the interrupt
 // monitoring the hard limit switch pins will enable the Arduino's watchdog timer to re-check
@@ -700,4 +813,8 @@
   #error "Override refresh must be greater than zero."
 #endif
 
+#if defined(PROGRAM_SIMULATION) && !(defined(PROGRAM_STORE) && defined(PROGRAM_VALIDATION))
+  #error "PROGRAM_SIMULATION requires PROGRAM_STORE and PROGRAM_VALIDATION."
+#endif
+
 #endif
@@ -493,4 +493,19 @@
   #define DEFAULT_HOMING_PULLOFF 1.0 // mm
 #endif
 
+// Per-axis junction velocity change limits ($140-$142), used only with JUNCTION_JERK_MODEL.
+// Shared by all default sets above, unless a set defines its own.
+#ifndef DEFAULT_X_MAX_JERK
+  #define DEFAULT_X_MAX_JERK 300.0 // mm/min (5 mm/sec)
+#endif
+#ifndef DEFAULT_Y_MAX_JERK
+  #define DEFAULT_Y_MAX_JERK 300.0 // mm/min (5 mm/sec)
+#endif
+#ifndef DEFAULT_Z_MAX_JERK
+  #define DEFAULT_Z_MAX_JERK 30.0 // mm/min (0.5 mm/sec)
+#endif
+#ifndef DEFAULT_STATUS_REPORT_INTERVAL
+  #define DEFAULT_STATUS_REPORT_INTERVAL 0 // ms, pushed status reports disabled
+#endif
+
 #endif
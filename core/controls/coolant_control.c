@@ -16,6 +16,9 @@
 #include "coolant_control.h"
 #include "hal_abstract.h"
 #include "nuts_bolts.h"
+#ifdef PROGRAM_SIMULATION
+  #include "validation.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -108,6 +111,10 @@ uint8_t coolant_get_state(void) {
 void coolant_sync(uint8_t mode) {
     /* */
     if (sys.state == STATE_CHECK_MODE) {
+        #ifdef PROGRAM_SIMULATION
+          /* a simulated job comes to a stop here as well */
+          if (validation_active()) { validation_synchronize(); }
+        #endif
         return;
     }
     /* ensure coolant turns on when specified in program */
@@ -25,28 +25,32 @@
 #include "config.h"
 #include "report.h"
 #include "nuts_bolts.h"
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static void mc_line_coordinated(float *target, plan_line_data_t *pl_data);
+
 /* Extern function -----------------------------------------------------------*/
 /* Private Functions ---------------------------------------------------------*/
-/* Exported Functions --------------------------------------------------------*/
-
 /**
-  * @brief  Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
-            unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
-            (1 minute)/feed_rate time.
-            NOTE: This is the primary gateway to the grbl planner. All line motions, including arc line
-            segments, must pass through this routine before being passed to the planner. The seperation of
-            mc_line and plan_buffer_line is done primarily to place non-planner-type functions from being
-            in the planner and to let backlash compensation or canned cycle integration simple and direct.
+  * @brief  Plans and queues one coordinated line motion. See mc_line().
   * @param  float *target, plan_line_data_t *pl_data
   * @retval None
   */
-void mc_line(float *target, plan_line_data_t *pl_data) {
+static void mc_line_coordinated(float *target, plan_line_data_t *pl_data) {
+    #ifdef PROGRAM_SIMULATION
+      /* soft limits are checked by the validation, no stepper interrupt frees the planner */
+      if (validation_active()) {
+          validation_plan(target, pl_data);
+          return;
+      }
+    #endif
     /* if enabled, check for soft limit violations, placed here all line motions
        are picked up from everywhere in grbl */
     if (bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
@@ -92,6 +96,87 @@ void mc_line(float *target, plan_line_data_t *pl_data) {
     }
 }
 
+#ifdef RAPID_NON_COORDINATED
+/**
+  * @brief  Executes a rapid motion as up to N_AXIS line motions instead of one coordinated line.
+            Within each line motion every axis still moving runs at its own maximum rate, so the
+            axes are only synchronized at the split points and no axis is slowed down to the pace
+            of the axis that needs the longest time. All split points lie inside the box spanned by
+            the start position and the target, hence checking the target covers the soft limits.
+  * @param  float *target, plan_line_data_t *pl_data
+  * @retval None
+  */
+static void mc_rapid_non_coordinated(float *target, plan_line_data_t *pl_data) {
+    float position[N_AXIS], sub_target[N_AXIS], axis_time[N_AXIS];
+    uint8_t idx;
+    /* check the final target before any part of the motion is planned, a simulated job has been
+       checked by validation_target() */
+    #ifdef PROGRAM_SIMULATION
+      uint8_t soft_limit_check = !validation_active();
+    #else
+      uint8_t soft_limit_check = true;
+    #endif
+    if (soft_limit_check && bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE)) {
+        limits_soft_check(target);
+        if (sys.abort) { return; }
+    }
+    /* time each axis needs on its own at maximum rate (min) */
+    plan_get_planner_mpos(position);
+    for (idx = 0; idx < N_AXIS; idx++) {
+        axis_time[idx] = fabsf(target[idx] - position[idx]) / settings.max_rate[idx];
+    }
+    /* each line motion ends when the next axis arrives at its target */
+    while (1) {
+        float dt = SOME_LARGE_VALUE;
+        for (idx = 0; idx < N_AXIS; idx++) {
+            if ((axis_time[idx] > 0.0f) && (axis_time[idx] < dt)) { dt = axis_time[idx]; }
+        }
+        if (dt == (float)SOME_LARGE_VALUE) { return; }
+        for (idx = 0; idx < N_AXIS; idx++) {
+            if (axis_time[idx] <= dt) {
+                sub_target[idx] = target[idx];
+                axis_time[idx] = 0.0f;
+            } else {
+                sub_target[idx] = position[idx] + (target[idx] - position[idx]) * (dt / axis_time[idx]);
+                axis_time[idx] -= dt;
+            }
+            position[idx] = sub_target[idx];
+        }
+        mc_line_coordinated(sub_target, pl_data);
+        if (sys.abort) { return; }
+    }
+}
+#endif
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  Execute linear motion in absolute millimeter coordinates. Feed rate given in millimeters/second
+            unless invert_feed_rate is true. Then the feed_rate means that the motion should be completed in
+            (1 minute)/feed_rate time.
+            NOTE: This is the primary gateway to the grbl planner. All line motions, including arc line
+            segments, must pass through this routine before being passed to the planner. The seperation of
+            mc_line and plan_buffer_line is done primarily to place non-planner-type functions from being
+            in the planner and to let backlash compensation or canned cycle integration simple and direct.
+  * @param  float *target, plan_line_data_t *pl_data
+  * @retval None
+  */
+void mc_line(float *target, plan_line_data_t *pl_data) {
+    #ifdef PROGRAM_VALIDATION
+      /* a job validated is not executed, its targets are only checked, and planned if simulated */
+      if (validation_active() && !validation_target(target)) { return; }
+    #endif
+    #ifdef RAPID_NON_COORDINATED
+      /* jog and system motions are never split, they must follow the commanded line */
+      if ((pl_data->condition & PL_COND_FLAG_RAPID_MOTION) &&
+          !(pl_data->condition & PL_COND_FLAG_SYSTEM_MOTION) && (sys.state != STATE_JOG)) {
+          mc_rapid_non_coordinated(target, pl_data);
+          return;
+      }
+    #endif
+    mc_line_coordinated(target, pl_data);
+}
+
 /**
   * @brief  Execute an arc in offset mode format. position == current xyz, target == target xyz,
             offset == offset from current xyz, axis_X defines circle plane in tool space, axis_linear is
@@ -215,6 +300,12 @@ void mc_arc(float *target, plan_line_data_t *pl_data, float *position, float *of
   * @retval None
   */
 void mc_dwell(float seconds) {
+    #ifdef PROGRAM_SIMULATION
+      if (validation_active()) {
+          validation_dwell(seconds);
+          return;
+      }
+    #endif
     if (sys.state == STATE_CHECK_MODE) {
         return;
     }
@@ -360,14 +451,14 @@ uint8_t mc_probe_cycle(float *target, plan_line_data_t *pl_data, uint8_t parser_
     if (plan_status) {
       bit_true(sys.step_control, STEP_CONTROL_EXECUTE_SYS_MOTION);
       bit_false(sys.step_control, STEP_CONTROL_END_MOTION); // Allow parking motion to execute, if feed hold is active.
-      st_parking_setup_buffer(); // Setup step segment buffer for special parking motion case
-      st_prep_buffer();
-      st_wake_up();
+      stepper_parking_setup_buffer(); // Setup step segment buffer for special parking motion case
+      stepper_prep_buffer();
+      stepper_wake_up();
       do {
         protocol_exec_rt_system();
         if (sys.abort) { return; }
       } while (sys.step_control & STEP_CONTROL_EXECUTE_SYS_MOTION);
-      st_parking_restore_buffer(); // Restore step segment buffer to normal run state.
+      stepper_parking_restore_buffer(); // Restore step segment buffer to normal run state.
     } else {
       bit_false(sys.step_control, STEP_CONTROL_EXECUTE_SYS_MOTION);
       protocol_exec_rt_system();
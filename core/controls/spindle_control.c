@@ -28,6 +28,9 @@
 #include "nuts_bolts.h"
 #include "hal_abstract.h"
 #include "config.h"
+#ifdef PROGRAM_SIMULATION
+  #include "validation.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -221,7 +224,13 @@ void spindle_set_state(uint8_t state, float rpm) {
   * @retval None
   */
 void spindle_sync(uint8_t state, float rpm) {
-    if (sys.state == STATE_CHECK_MODE) { return; }
+    if (sys.state == STATE_CHECK_MODE) {
+        #ifdef PROGRAM_SIMULATION
+          /* a simulated job comes to a stop here as well */
+          if (validation_active()) { validation_synchronize(); }
+        #endif
+        return;
+    }
     /* empty planner buffer to ensure spindle is set when programmed */
     protocol_buffer_synchronize();
     spindle_set_state(state,rpm);
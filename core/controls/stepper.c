@@ -229,7 +229,7 @@ void stepper_update_plan_block_parameters(void) {
     if (st_blocks.pl_block != NULL) {
         prep.recalculate_flag |= PREP_FLAG_RECALCULATE;
         /* Update entry speed. */
-        st_blocks.pl_block->entry_speed_sqr = prep.current_speed*prep.current_speed;
+        st_blocks.pl_speed->entry_speed_sqr = prep.current_speed*prep.current_speed;
         /* Flag st_prep_segment() to load and check active velocity profile. */
         st_blocks.pl_block = NULL;
     }
@@ -268,6 +268,7 @@ void stepper_prep_buffer(void) {
       if (st_blocks.pl_block == NULL) {
           return;
       }
+      st_blocks.pl_speed = plan_get_block_speed(st_blocks.pl_block);
       /* Check if we need to only recompute the velocity profile or load a new block */
       if (prep.recalculate_flag & PREP_FLAG_RECALCULATE) {
           #ifdef PARKING_ENABLE
@@ -302,18 +303,18 @@ void stepper_prep_buffer(void) {
           #endif
           /* Initialize segment buffer data for generating the segments */
           prep.steps_remaining = (float)st_blocks.pl_block->step_event_count;
-          prep.step_per_mm = prep.steps_remaining / st_blocks.pl_block->millimeters;
+          prep.step_per_mm = prep.steps_remaining / st_blocks.pl_speed->millimeters;
           prep.req_mm_increment = REQ_MM_INCREMENT_SCALAR / prep.step_per_mm;
           prep.dt_remainder = 0.0; // Reset for new segment block
           /* */
           if ((sys.step_control & STEP_CONTROL_EXECUTE_HOLD) || (prep.recalculate_flag & PREP_FLAG_DECEL_OVERRIDE)) {
               /* New block loaded mid-hold. Override planner block entry speed to enforce deceleration */
               prep.current_speed = prep.exit_speed;
-              st_blocks.pl_block->entry_speed_sqr = prep.exit_speed * prep.exit_speed;
+              st_blocks.pl_speed->entry_speed_sqr = prep.exit_speed * prep.exit_speed;
               prep.recalculate_flag &= ~(PREP_FLAG_DECEL_OVERRIDE);
           }
           else {
-              prep.current_speed = sqrt(st_blocks.pl_block->entry_speed_sqr);
+              prep.current_speed = sqrt(st_blocks.pl_speed->entry_speed_sqr);
           }
 
           #ifdef VARIABLE_SPINDLE
@@ -336,16 +337,16 @@ void stepper_prep_buffer(void) {
 			 hold, override the planner velocities and decelerate to the target exit speed.
 			*/
 			prep.mm_complete = 0.0; // Default velocity profile complete at 0.0mm from end of block.
-			float inv_2_accel = 0.5/st_blocks.pl_block->acceleration;
+			float inv_2_accel = 0.5/st_blocks.pl_speed->acceleration;
 			if (sys.step_control & STEP_CONTROL_EXECUTE_HOLD) { // [Forced Deceleration to Zero Velocity]
 				// Compute velocity profile parameters for a feed hold in-progress. This profile overrides
 				// the planner block profile, enforcing a deceleration to zero speed.
 				prep.ramp_type = RAMP_DECEL;
 				// Compute decelerate distance relative to end of block.
-				float decel_dist = st_blocks.pl_block->millimeters - inv_2_accel*st_blocks.pl_block->entry_speed_sqr;
+				float decel_dist = st_blocks.pl_speed->millimeters - inv_2_accel*st_blocks.pl_speed->entry_speed_sqr;
 				if (decel_dist < 0.0) {
 					// Deceleration through entire planner block. End of feed hold is not in this block.
-					prep.exit_speed = sqrt( st_blocks.pl_block->entry_speed_sqr - (2 * st_blocks.pl_block->acceleration * st_blocks.pl_block->millimeters) );
+					prep.exit_speed = sqrt( st_blocks.pl_speed->entry_speed_sqr - (2 * st_blocks.pl_speed->acceleration * st_blocks.pl_speed->millimeters) );
 				}
         else {
 					prep.mm_complete = decel_dist; // End of feed hold.
@@ -355,7 +356,7 @@ void stepper_prep_buffer(void) {
       else { // [Normal Operation]
 				// Compute or recompute velocity profile parameters of the prepped planner block.
 				prep.ramp_type = RAMP_ACCEL; // Initialize as acceleration ramp.
-				prep.accelerate_until = st_blocks.pl_block->millimeters;
+				prep.accelerate_until = st_blocks.pl_speed->millimeters;
 
 				float exit_speed_sqr;
 				float nominal_speed;
@@ -370,17 +371,17 @@ void stepper_prep_buffer(void) {
         nominal_speed = plan_compute_profile_nominal_speed(st_blocks.pl_block);
 				float nominal_speed_sqr = nominal_speed*nominal_speed;
 				float intersect_distance =
-								0.5*(st_blocks.pl_block->millimeters+inv_2_accel*(st_blocks.pl_block->entry_speed_sqr-exit_speed_sqr));
+								0.5*(st_blocks.pl_speed->millimeters+inv_2_accel*(st_blocks.pl_speed->entry_speed_sqr-exit_speed_sqr));
 
-        if (st_blocks.pl_block->entry_speed_sqr > nominal_speed_sqr) { // Only occurs during override reductions.
-          prep.accelerate_until = st_blocks.pl_block->millimeters - inv_2_accel*(st_blocks.pl_block->entry_speed_sqr-nominal_speed_sqr);
+        if (st_blocks.pl_speed->entry_speed_sqr > nominal_speed_sqr) { // Only occurs during override reductions.
+          prep.accelerate_until = st_blocks.pl_speed->millimeters - inv_2_accel*(st_blocks.pl_speed->entry_speed_sqr-nominal_speed_sqr);
           if (prep.accelerate_until <= 0.0) { // Deceleration-only.
             prep.ramp_type = RAMP_DECEL;
-            // prep.decelerate_after = st_blocks.pl_block->millimeters;
+            // prep.decelerate_after = st_blocks.pl_speed->millimeters;
             // prep.maximum_speed = prep.current_speed;
 
             // Compute override block exit speed since it doesn't match the planner exit speed.
-            prep.exit_speed = sqrt(st_blocks.pl_block->entry_speed_sqr - 2*st_blocks.pl_block->acceleration*st_blocks.pl_block->millimeters);
+            prep.exit_speed = sqrt(st_blocks.pl_speed->entry_speed_sqr - 2*st_blocks.pl_speed->acceleration*st_blocks.pl_speed->millimeters);
             prep.recalculate_flag |= PREP_FLAG_DECEL_OVERRIDE; // Flag to load next block as deceleration override.
 
             // TODO: Determine correct handling of parameters in deceleration-only.
@@ -396,29 +397,29 @@ void stepper_prep_buffer(void) {
           }
 				}
         else if (intersect_distance > 0.0) {
-					if (intersect_distance < st_blocks.pl_block->millimeters) { // Either trapezoid or triangle types
+					if (intersect_distance < st_blocks.pl_speed->millimeters) { // Either trapezoid or triangle types
 						// NOTE: For acceleration-cruise and cruise-only types, following calculation will be 0.0.
 						prep.decelerate_after = inv_2_accel*(nominal_speed_sqr-exit_speed_sqr);
 						if (prep.decelerate_after < intersect_distance) { // Trapezoid type
 							prep.maximum_speed = nominal_speed;
-							if ( (int32_t)st_blocks.pl_block->entry_speed_sqr == (int32_t)nominal_speed_sqr) {
+							if ( (int32_t)st_blocks.pl_speed->entry_speed_sqr == (int32_t)nominal_speed_sqr) {
 								// Cruise-deceleration or cruise-only type.
 								prep.ramp_type = RAMP_CRUISE;
 							}
               else {
 								// Full-trapezoid or acceleration-cruise types
-								prep.accelerate_until -= inv_2_accel*(nominal_speed_sqr-st_blocks.pl_block->entry_speed_sqr);
+								prep.accelerate_until -= inv_2_accel*(nominal_speed_sqr-st_blocks.pl_speed->entry_speed_sqr);
 							}
 						}
             else { // Triangle type
 							prep.accelerate_until = intersect_distance;
 							prep.decelerate_after = intersect_distance;
-							prep.maximum_speed = sqrt(2.0*st_blocks.pl_block->acceleration*intersect_distance+exit_speed_sqr);
+							prep.maximum_speed = sqrt(2.0*st_blocks.pl_speed->acceleration*intersect_distance+exit_speed_sqr);
 						}
 					}
           else { // Deceleration-only type
             prep.ramp_type = RAMP_DECEL;
-            // prep.decelerate_after = st_blocks.pl_block->millimeters;
+            // prep.decelerate_after = st_blocks.pl_speed->millimeters;
             // prep.maximum_speed = prep.current_speed;
 					}
 				}
@@ -459,18 +460,18 @@ void stepper_prep_buffer(void) {
     float time_var = dt_max; // Time worker variable
     float mm_var; // mm-Distance worker variable
     float speed_var; // Speed worker variable
-    float mm_remaining = st_blocks.pl_block->millimeters; // New segment distance from end of block.
+    float mm_remaining = st_blocks.pl_speed->millimeters; // New segment distance from end of block.
     float minimum_mm = mm_remaining-prep.req_mm_increment; // Guarantee at least one step.
     if (minimum_mm < 0.0) { minimum_mm = 0.0; }
 
     do {
       switch (prep.ramp_type) {
         case RAMP_DECEL_OVERRIDE:
-          speed_var = st_blocks.pl_block->acceleration*time_var;
+          speed_var = st_blocks.pl_speed->acceleration*time_var;
           if (prep.current_speed-prep.maximum_speed <= speed_var) {
             // Cruise or cruise-deceleration types only for deceleration override.
             mm_remaining = prep.accelerate_until;
-            time_var = 2.0*(st_blocks.pl_block->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
+            time_var = 2.0*(st_blocks.pl_speed->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
             prep.ramp_type = RAMP_CRUISE;
             prep.current_speed = prep.maximum_speed;
           } else { // Mid-deceleration override ramp.
@@ -480,13 +481,13 @@ void stepper_prep_buffer(void) {
           break;
         case RAMP_ACCEL:
           // NOTE: Acceleration ramp only computes during first do-while loop.
-          speed_var = st_blocks.pl_block->acceleration*time_var;
+          speed_var = st_blocks.pl_speed->acceleration*time_var;
           mm_remaining -= time_var*(prep.current_speed + 0.5*speed_var);
           if (mm_remaining < prep.accelerate_until) { // End of acceleration ramp.
             // Acceleration-cruise, acceleration-deceleration ramp junction, or end of block.
             mm_remaining = prep.accelerate_until; // NOTE: 0.0 at EOB
-            time_var = 2.0*(st_blocks.pl_block->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
-            if ( (int32_t)mm_remaining == (int32_t)prep.decelerate_after ) { prep.ramp_type = RAMP_DECEL; }
+            time_var = 2.0*(st_blocks.pl_speed->millimeters-mm_remaining)/(prep.current_speed+prep.maximum_speed);
+            if (mm_remaining == prep.decelerate_after) { prep.ramp_type = RAMP_DECEL; }
             else { prep.ramp_type = RAMP_CRUISE; }
             prep.current_speed = prep.maximum_speed;
           } else { // Acceleration only.
@@ -509,7 +510,7 @@ void stepper_prep_buffer(void) {
           break;
         default: // case RAMP_DECEL:
           // NOTE: mm_var used as a misc worker variable to prevent errors when near zero speed.
-          speed_var = st_blocks.pl_block->acceleration*time_var; // Used as delta speed (mm/min)
+          speed_var = st_blocks.pl_speed->acceleration*time_var; // Used as delta speed (mm/min)
           if (prep.current_speed > speed_var) { // Check if at or below zero speed.
             // Compute distance from end of segment to end of block.
             mm_var = mm_remaining - time_var*(prep.current_speed - 0.5*speed_var); // (mm)
@@ -639,12 +640,12 @@ void stepper_prep_buffer(void) {
     if ( ++segments.next_head == STEPPER_SEGMENT_BUFFER_SIZE ) { segments.next_head = 0; }
 
     // Update the appropriate planner and segment data.
-    st_blocks.pl_block->millimeters = mm_remaining;
+    st_blocks.pl_speed->millimeters = mm_remaining;
     prep.steps_remaining = n_steps_remaining;
     prep.dt_remainder = (n_steps_remaining - step_dist_remaining)*inv_rate;
 
     // Check for exit conditions and flag to load next planner block.
-    if ( (int32_t)mm_remaining == (int32_t)prep.mm_complete ) {
+    if (mm_remaining == prep.mm_complete) {
       // End of planner block or forced-termination. No more distance to be executed.
       if (mm_remaining > 0.0) { // At end of forced-termination.
         // Reset prep parameters for resuming and then bail. Allow the stepper ISR to complete
@@ -669,6 +670,39 @@ void stepper_prep_buffer(void) {
   }
 }
 
+#ifdef PROGRAM_SIMULATION
+
+/**
+  * @brief  Takes the next step segment from the segment buffer in place of the stepper ISR, for a
+            simulated run. No steps are output, the time the ISR would take for the segment is
+            computed from its step count and step timing.
+  * @param  uint64_t *ticks, set to the stepper timer ticks of the segment, uint8_t *block_start,
+            set true if the segment starts a new planner block
+  * @retval true if a segment has been taken, false if the segment buffer is empty
+  */
+uint8_t stepper_simulate_segment(uint64_t *ticks, uint8_t *block_start) {
+    /* */
+    if (segments.head == segments.tail) { return false; }
+    segment_t *segment = &segments.buffer[segments.tail];
+    /* track the block index as the ISR does, so that the next run loads its first block */
+    *block_start = (stepper.exec_block_index != segment->st_block_index);
+    if (*block_start) {
+        stepper.exec_block_index = segment->st_block_index;
+        stepper.exec_block = &st_blocks.buffer[stepper.exec_block_index];
+    }
+    /* one ISR tick per step event, each cycles_per_tick long */
+    *ticks = (uint64_t)segment->n_step * segment->cycles_per_tick;
+    #ifndef ADAPTIVE_MULTI_AXIS_STEP_SMOOTHING
+      /* prescaler 1, 2 and 3 divide the timer clock by 1, 8 and 64 */
+      *ticks <<= 3*(segment->prescaler - 1);
+    #endif
+    /* */
+    if ( ++segments.tail == STEPPER_SEGMENT_BUFFER_SIZE) { segments.tail = 0; }
+    return true;
+}
+
+#endif  /* PROGRAM_SIMULATION */
+
 #ifdef PARKING_ENABLE
 
 /**
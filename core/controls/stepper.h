@@ -40,6 +40,10 @@ extern void stepper_prep_buffer(void);
 extern void stepper_update_plan_block_parameters(void);
 extern float stepper_get_realtime_rate(void);
 
+#ifdef PROGRAM_SIMULATION
+extern uint8_t stepper_simulate_segment(uint64_t *ticks, uint8_t *block_start);
+#endif
+
 #ifdef PARKING_ENABLE
 extern void stepper_parking_setup_buffer(void);
 extern void stepper_parking_restore_buffer(void);
@@ -46,6 +46,7 @@ typedef struct _st_block_buffer_t {
        Accessed only by the main program. Pointers may be planning segments
        or planner blocks ahead of what being executed */
     plan_block_t *pl_block;     // planner block being prepped
+    plan_block_speed_t *pl_speed; // planning data of the block being prepped
     st_block_t *st_prep_block;  // stepper block data being prepped
 } st_block_buffer_t;
 
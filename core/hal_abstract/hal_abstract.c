@@ -78,9 +78,34 @@ __weak void ngrbl_hal_eeprom_init(void) { /* */ }
 __weak uint8_t ngrbl_hal_eeprom_read_byte(uint16_t addr) { return 0; }
 __weak void ngrbl_hal_eeprom_write_byte(uint16_t addr, uint8_t new_value) { /* */ }
 
+/* STORAGE -------------------------------------------------------------------*/
+/* Block storage for local programs, blocks of NGRBL_HAL_STORAGE_BLOCK_SIZE bytes. Defaults to no
+   storage for ports without it */
+__weak uint32_t ngrbl_hal_storage_get_block_count(void) { return 0; }
+/* Starts reading a block, ngrbl_hal_storage_read_callback() must be called once the data is
+   complete, with false if it could not be read. Defaults to failing at once */
+__weak void ngrbl_hal_storage_read_block(uint32_t block, uint8_t *data) {
+    ngrbl_hal_storage_read_callback(0);
+}
+/* Writes a block, erasing it first if the medium requires. Returns true upon success */
+__weak uint8_t ngrbl_hal_storage_write_block(uint32_t block, const uint8_t *data) { return 0; }
+
 /* SERIAL --------------------------------------------------------------------*/
 __weak void ngrbl_hal_serail_init(uint32_t baudrate) { /* */ }
 __weak void ngrbl_hal_serial_write_byte(uint8_t data) { /* */ }
+/* Starts a bulk transfer, ngrbl_hal_serial_tx_callback() must be called once it is complete and the
+   data is no longer accessed. Defaults to blocking single byte writes for ports without bulk TX */
+__weak void ngrbl_hal_serial_write(uint8_t *data, uint16_t length) {
+    while (length--) {
+        ngrbl_hal_serial_write_byte(*data++);
+    }
+    ngrbl_hal_serial_tx_callback();
+}
+/* Same for the additional channels (SERIAL_CHANNELS), with ngrbl_hal_serial_channel_tx_callback().
+   Defaults to dropping the data for ports without additional channels */
+__weak void ngrbl_hal_serial_channel_write(uint8_t channel, uint8_t *data, uint16_t length) {
+    ngrbl_hal_serial_channel_tx_callback(channel);
+}
 __weak void ngrbl_hal_serail_stop_tx(void) { /* */ }
 
 /* UTILS ---------------------------------------------------------------------*/
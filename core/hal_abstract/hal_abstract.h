@@ -16,6 +16,9 @@
 #include <stdint.h>
 
 /* Exported define -----------------------------------------------------------*/
+#ifndef NGRBL_HAL_STORAGE_BLOCK_SIZE
+  #define NGRBL_HAL_STORAGE_BLOCK_SIZE    256   // Bytes of a program storage block, see STORAGE
+#endif
 /* Exported macro ------------------------------------------------------------*/
 /* Exported typedef ----------------------------------------------------------*/
 typedef enum {
@@ -112,16 +115,29 @@ void ngrbl_hal_eeprom_init(void);
 uint8_t ngrbl_hal_eeprom_read_byte(uint16_t addr);
 void ngrbl_hal_eeprom_write_byte(uint16_t addr, uint8_t new_value);
 
+/* STORAGE -------------------------------------------------------------------*/
+uint32_t ngrbl_hal_storage_get_block_count(void);
+void ngrbl_hal_storage_read_block(uint32_t block, uint8_t *data);
+uint8_t ngrbl_hal_storage_write_block(uint32_t block, const uint8_t *data);
+/* HAL callbacks */
+extern void ngrbl_hal_storage_read_callback(uint8_t success);
+
 /* SERIAL --------------------------------------------------------------------*/
 void ngrbl_hal_serail_init(uint32_t baudrate);
 void ngrbl_hal_serial_write_byte(uint8_t data);
+void ngrbl_hal_serial_write(uint8_t *data, uint16_t length);
+void ngrbl_hal_serial_channel_write(uint8_t channel, uint8_t *data, uint16_t length);
 void ngrbl_hal_serail_stop_tx(void);
 
 extern void ngrbl_hal_serial_tx_callback(void);
 extern void ngrbl_hal_serial_rx_callback(uint8_t* data, uint16_t length);
+extern void ngrbl_hal_serial_channel_tx_callback(uint8_t channel);
+extern void ngrbl_hal_serial_channel_rx_callback(uint8_t channel, uint8_t* data, uint16_t length);
 
 /* UTILS ---------------------------------------------------------------------*/
 void ngrbl_hal_delay_ms(uint16_t val);
+/* HAL callbacks */
+extern void ngrbl_sys_tick_callback(void);
 
 
 #endif /* __GRBL_HAL__H */
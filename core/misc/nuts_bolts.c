@@ -18,13 +18,124 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
-#define MAX_INT_DIGITS        8 // Maximum number of digits in int32 (and float)
+#define MAX_INT32_DIGITS      9           // Significant digits accumulated in uint32
+#define MAX_INT_DIGITS        18          // Maximum number of significant digits, in uint64
+#define MAX_INT_DIGITS_SPLIT  11          // Second divisor power of ten, 2^26 * 10^11 fits in uint64
+#define FLOAT_EXACT_INT       16777216UL  // 2^24, integers up to this are exact in float
+#define FLOAT_EXACT_POW10     10          // 10^10 is the largest power of ten exact in float
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+static const float pow10_table[FLOAT_EXACT_POW10 + 1] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+/* Nearest float of 10^-n */
+static const float pow10_inverse_table[FLOAT_EXACT_POW10 + 1] = {
+    1e0f, 1e-1f, 1e-2f, 1e-3f, 1e-4f, 1e-5f, 1e-6f, 1e-7f, 1e-8f, 1e-9f, 1e-10f
+};
+static const uint64_t pow10_uint64_table[MAX_INT_DIGITS + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL
+};
+
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
 /* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Multiplies two uint64 to the full 128-bit product, from 32-bit partial products.
+  * @param  uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo
+  * @retval None
+  */
+static void _mul_uint64(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo) {
+    uint64_t p0 = (a & 0xFFFFFFFFULL) * (b & 0xFFFFFFFFULL);
+    uint64_t p1 = (a & 0xFFFFFFFFULL) * (b >> 32);
+    uint64_t p2 = (a >> 32) * (b & 0xFFFFFFFFULL);
+    uint64_t p3 = (a >> 32) * (b >> 32);
+    uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFULL) + (p2 & 0xFFFFFFFFULL);
+    *lo = (mid << 32) | (p0 & 0xFFFFFFFFULL);
+    *hi = p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+}
+
+/**
+  * @brief  Converts intval * 10^exp to the nearest float, for numbers out of the single operation
+            range of read_float(). The product or quotient is computed in integer arithmetic to 26 or
+            more significant bits, with any remainder folded into the lowest bit, so the one integer
+            to float conversion rounds correctly. Exact for exp from -29 up to the float
+            range, beyond these, far outside of any g-code value, the scaling rounds once per step.
+  * @param  uint64_t intval, int16_t exp, bool_g inexact, true if non-zero digits were dropped
+  * @retval float value
+  */
+static float _read_float_scale(uint64_t intval, int16_t exp, bool_g inexact) {
+    float fval;
+    /* zero with leading zeros past the table range */
+    if (intval == 0) {
+        return 0.0f;
+    }
+    if (exp >= 0) {
+        while ((exp > 0) && (intval <= (UINT64_MAX / 10))) {
+            intval *= 10;
+            exp--;
+        }
+        if (exp == 0) {
+            return (float)(inexact ? (intval | 1) : intval);
+        }
+        if (exp <= MAX_INT_DIGITS) {
+            uint64_t hi, lo;
+            _mul_uint64(intval, pow10_uint64_table[exp], &hi, &lo);
+            /* normalize to the top 64 bits, hi is not zero */
+            uint8_t n = __builtin_clzll(hi);
+            uint64_t top = (n == 0) ? hi : ((hi << n) | (lo >> (64 - n)));
+            if (((lo << n) != 0) || inexact) {
+                top |= 1; // Inexact, rounds like any value past the half way
+            }
+            return ldexpf((float)top, 64 - n);
+        }
+        fval = (float)intval;
+        while (exp-- > 0) {
+            fval *= 10.0f;
+        }
+        return fval;
+    }
+    /* */
+    float post_scale = 1.0f;
+    while (exp < -(MAX_INT_DIGITS + MAX_INT_DIGITS_SPLIT)) {
+        post_scale *= 0.1f;
+        exp++;
+    }
+    /* the quotient by 10^-exp is taken in two steps beyond 10^MAX_INT_DIGITS, as
+       floor(floor(n / a) / b) equals floor(n / (a*b)) */
+    uint8_t k = -exp;
+    uint64_t divisor = pow10_uint64_table[min(k, MAX_INT_DIGITS)];
+    uint64_t divisor_split = (k > MAX_INT_DIGITS) ? pow10_uint64_table[k - MAX_INT_DIGITS] : 1;
+    uint64_t q = intval / divisor;
+    uint64_t r = intval % divisor;
+    int16_t shift = 0;
+    /* Extend the quotient, the remainder stays below the divisor, so it may be shifted by the
+       leading zeros of the divisor, at least 4 bits */
+    while (q < ((1ULL << 26) * divisor_split)) {
+        uint8_t step = min(__builtin_clzll(divisor), 36);
+        if (q != 0) {
+            step = min(step, __builtin_clzll(q));
+        }
+        r <<= step;
+        q = (q << step) + (r / divisor);
+        r %= divisor;
+        shift += step;
+    }
+    if (divisor_split != 1) {
+        r |= q % divisor_split;
+        q /= divisor_split;
+    }
+    if ((r != 0) || inexact) {
+        q |= 1; // Inexact, rounds like any value past the half way
+    }
+    fval = ldexpf((float)q, -shift);
+    return fval * post_scale;
+}
+
 /* Exported Functions --------------------------------------------------------*/
 
 /**
@@ -52,21 +163,36 @@ uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr) {
     } else if (c == '+') {
       c = *ptr++;
     }
-    /* extract number into fast integer, track decimal in terms of exponent value */
+    /* extract number into fast integer, track decimal in terms of exponent value. Numbers up to
+       MAX_INT32_DIGITS significant digits take the 32-bit accumulation only */
     uint32_t intval = 0;
-    int8_t exp = 0;
+    uint64_t intval64 = 0;
+    int16_t exp = 0;
     uint8_t ndigit = 0;
+    bool_g hasdigit = false;
+    bool_g inexact = false;
     bool_g isdecimal = false;
     while(1) {
         c -= '0';
         if (c <= 9) {
-            ndigit++;
-            if (ndigit <= MAX_INT_DIGITS) {
+            hasdigit = true;
+            if ((ndigit == 0) && (c == 0)) {
+                if (isdecimal) exp--; // leading zero, not significant
+            }
+            else if (ndigit < MAX_INT32_DIGITS) {
+                ndigit++;
                 if (isdecimal) exp--;
                 intval = (((intval << 2) + intval) << 1) + c; // intval*10 + c
             }
+            else if (ndigit < MAX_INT_DIGITS) {
+                if (ndigit == MAX_INT32_DIGITS) { intval64 = intval; }
+                ndigit++;
+                if (isdecimal) exp--;
+                intval64 = intval64*10 + c;
+            }
             else {
                 if (!(isdecimal)) exp++;  // drop overflow digits
+                if (c != 0) inexact = true;
             }
         }
         else if (c == (('.'-'0') & 0xff)  &&  !(isdecimal)) {
@@ -79,26 +205,30 @@ uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr) {
     }
 
     /* return if no digits have been read */
-    if (!ndigit) { return(false); };
-    /* convert integer into floating point */
+    if (!hasdigit) { return(false); };
+    /* convert integer into floating point with correct rounding. The typical value of up to 7
+       digits, E-10 to E10, is exact as integer and power of ten, so one operation rounds it: a
+       multiply, or the quotient by multiply with the nearest inverse power of ten and a fused
+       multiply-add correction by the exact remainder, cheaper than a division */
     float fval;
-    fval = (float)intval;
-    /* apply decimal, should perform no more than two floating point multiplications
-       for the expected range of E0 to E-4 */
-    if ((int32_t)fval != 0) {
-        while (exp <= -2) {
-            fval *= 0.01;
-            exp += 2;
-        }
-        if (exp < 0) {
-            fval *= 0.1;
+    if (ndigit > MAX_INT32_DIGITS) {
+        fval = _read_float_scale(intval64, exp, inexact);
+    }
+    else if ((intval > FLOAT_EXACT_INT) || (exp < -FLOAT_EXACT_POW10) || (exp > FLOAT_EXACT_POW10)) {
+        fval = _read_float_scale(intval, exp, false);
+    }
+    else {
+        fval = (float)intval;
+        if (exp > 0) {
+            fval *= pow10_table[exp];
         }
-        else if (exp > 0) {
-            do {
-                fval *= 10.0;
-            } while (--exp > 0);
+        else if (exp < 0) {
+            float q = fval * pow10_inverse_table[-exp];
+            float r = fmaf(-q, pow10_table[-exp], fval); // exact remainder
+            fval = fmaf(r, pow10_inverse_table[-exp], q);
         }
     }
+
     /* assign floating point value with correct sign */
     if (isnegative) {
         *float_ptr = -fval;
@@ -121,6 +251,42 @@ float hypot_f(float x, float y) {
     return(sqrt(x*x + y*y));
 }
 
+/**
+  * @brief  Reciprocal square root. With FAST_INV_SQRT the initial guess is taken from the float bit
+            pattern and refined by two Newton-Raphson iterations, relative error is below 5e-6.
+            Otherwise falls back to the single precision sqrtf().
+  * @param  float x, must be greater than zero
+  * @retval 1/sqrt(x)
+  */
+float inv_sqrt_f(float x) {
+  #ifdef FAST_INV_SQRT
+    union { float f; uint32_t i; } conv = { .f = x };
+    float half_x = 0.5f*x;
+    conv.i = 0x5f375a86 - (conv.i >> 1);
+    conv.f *= 1.5f - (half_x*conv.f*conv.f);
+    conv.f *= 1.5f - (half_x*conv.f*conv.f);
+    return conv.f;
+  #else
+    return 1.0f/sqrtf(x);
+  #endif
+}
+
+/**
+  * @brief  CRC-16/CCITT, poly 0x1021, init 0xFFFF. Used by the binary frames on the serial link.
+  * @param  uint8_t *data, uint16_t length
+  * @retval crc
+  */
+uint16_t crc16_ccitt(const uint8_t *data, uint16_t length) {
+    uint16_t crc = 0xFFFF;
+    while (length--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
 /**
   * @brief  simple convert delta vector to unit vector
   * @param  float *vector
@@ -128,18 +294,15 @@ float hypot_f(float x, float y) {
   */
 float convert_delta_vector_to_unit_vector(float *vector) {
     uint8_t i;
-    float magnitude = 0.0;
+    float magnitude_sqr = 0.0f;
     for (i = 0; i < N_AXIS; i++) {
-        if ((int32_t)vector[i] != 0) {
-            magnitude += vector[i]*vector[i];
-        }
+        magnitude_sqr += vector[i]*vector[i];
     }
-    magnitude = sqrt(magnitude);
-    float inv_magnitude = 1.0/magnitude;
+    float inv_magnitude = inv_sqrt_f(magnitude_sqr);
     for (i = 0; i < N_AXIS; i++) {
         vector[i] *= inv_magnitude;
     }
-    return magnitude;
+    return magnitude_sqr*inv_magnitude;
 }
 
 /**
@@ -150,8 +313,8 @@ float convert_delta_vector_to_unit_vector(float *vector) {
 float limit_value_by_axis_maximum(float *max_value, float *unit_vec) {
     float limit_value = SOME_LARGE_VALUE;
     for (uint8_t i = 0; i < N_AXIS; i++) {
-        if ((int32_t)unit_vec[i] != 0) {
-            limit_value = min( limit_value, fabs(max_value[i] / unit_vec[i]) );
+        if (unit_vec[i] != 0.0f) {
+            limit_value = min( limit_value, fabsf(max_value[i] / unit_vec[i]) );
         }
     }
     return limit_value;
@@ -67,6 +67,8 @@ typedef enum { true_g, false_g } bool_g;
 /* Exported function ---------------------------------------------------------*/
 extern uint8_t read_float(char *line, uint8_t *char_counter, float *float_ptr);
 extern float hypot_f(float x, float y);
+extern float inv_sqrt_f(float x);
+extern uint16_t crc16_ccitt(const uint8_t *data, uint16_t length);
 extern float convert_delta_vector_to_unit_vector(float *vector);
 extern float limit_value_by_axis_maximum(float *max_value, float *unit_vec);
 extern void delay_sec_nonblock(float seconds, uint8_t mode);
@@ -41,6 +41,7 @@ volatile uint8_t sys_rt_exec_accessory_override; // Global realtime executor bit
 #ifdef DEBUG
   volatile uint8_t sys_rt_exec_debug;
 #endif
+volatile uint8_t sys_rt_exec_report;
 
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
@@ -121,6 +122,7 @@ void ngrbl_main_loop(void) {
     sys_rt_exec_alarm = 0;
     sys_rt_exec_motion_override = 0;
     sys_rt_exec_accessory_override = 0;
+    sys_rt_exec_report = 0;
 
     /* Reset ngrbl primary systems. */
     serial_reset_read_buffer();
@@ -19,8 +19,24 @@
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
+#define PRINT_FLOAT_MAX_DECIMALS  8
+/* sign, up to 10 integer digits or the decimals with leading zero, decimal point */
+#define PRINT_FLOAT_BUFFER_SIZE   (1 + max(10, PRINT_FLOAT_MAX_DECIMALS + 1) + 1)
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+static const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
 /* Private Functions ---------------------------------------------------------*/
@@ -118,15 +134,24 @@ void printInteger(int64_t n) {
 /**
   * @brief  Convert float to string by immediately converting to a long integer, which contains
             more digits than a float. Number of decimal places, which are tracked by a counter,
-            may be set by the user. The integer is then efficiently converted to a string.
-            NOTE: AVR '%' and '/' integer operations are very efficient. Bitshifting speed-up
-            techniques are actually just slightly slower. Found this out the hard way.
-  * @param  float n, uint8_t decimal_places
+            may be set by the user. The integer is then converted two digits per division through
+            the digit pair table, into a local buffer that is written to the serial buffer at once.
+            NOTE: The scaling keeps the float multiply sequence by 100 and 10, so the rounding and
+            the output are the same as with the per digit conversion.
+  * @param  float n, uint8_t decimal_places, clamped to PRINT_FLOAT_MAX_DECIMALS
   * @retval None
   */
 void printFloat(float n, uint8_t decimal_places) {
+    uint8_t buf[PRINT_FLOAT_BUFFER_SIZE];
+    uint8_t end = PRINT_FLOAT_BUFFER_SIZE;
+    uint8_t start = end;
+    uint8_t isnegative = false;
+    /* */
+    if (decimal_places > PRINT_FLOAT_MAX_DECIMALS) {
+        decimal_places = PRINT_FLOAT_MAX_DECIMALS;
+    }
     if (n < 0) {
-        serial_write('-');
+        isnegative = true;
         n = -n;
     }
     /* */
@@ -138,25 +163,38 @@ void printFloat(float n, uint8_t decimal_places) {
     if (decimals) { n *= 10; }
     n += 0.5; // Add rounding factor. Ensures carryover through entire value.
 
-    /* Generate digits backwards and store in string */
-    unsigned char buf[13];
-    uint8_t i = 0;
+    /* Generate digits backwards, two at a time */
     uint32_t a = (long)n;
-    while(a > 0) {
-        buf[i++] = (a % 10) + '0'; // Get digit
-        a /= 10;
-    }
-    while (i < decimal_places) {
-         buf[i++] = '0'; // Fill in zeros to decimal point for (n < 1)
-    }
-    if (i == decimal_places) { // Fill in leading zero, if needed.
-        buf[i++] = '0';
-    }
-    // Print the generated string.
-    for (; i > 0; i--) {
-        if (i == decimal_places) { serial_write('.'); } // Insert decimal point in right place.
-        serial_write(buf[i-1]);
+    while (a >= 100) {
+        uint32_t q = a / 100;
+        const char *pair = &digit_pairs[(a - q*100) << 1];
+        buf[--start] = pair[1];
+        buf[--start] = pair[0];
+        a = q;
+    }
+    if (a >= 10) {
+        buf[--start] = digit_pairs[(a << 1) + 1];
+        buf[--start] = digit_pairs[a << 1];
+    }
+    else if (a > 0) {
+        buf[--start] = '0' + a;
+    }
+    /* Fill in zeros to decimal point for (n < 1) and the leading zero, if needed */
+    while ((end - start) <= decimal_places) {
+        buf[--start] = '0';
+    }
+    /* Insert decimal point in right place, by moving the integer digits one to the front */
+    if (decimal_places) {
+        uint8_t int_digits = end - start - decimal_places;
+        memmove(&buf[start - 1], &buf[start], int_digits);
+        start--;
+        buf[start + int_digits] = '.';
+    }
+    if (isnegative) {
+        buf[--start] = '-';
     }
+    /* */
+    serial_write_block(&buf[start], end - start);
 }
 
 /**
@@ -45,6 +45,7 @@
 
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
+static void report_util_realtime_status(uint8_t pushed);
 /* Extern function -----------------------------------------------------------*/
 /* Private Functions ---------------------------------------------------------*/
 
@@ -163,6 +164,20 @@ void report_feedback_message(uint8_t message_code) {
   report_util_feedback_line_feed();
 }
 
+#ifdef LINE_CHECKSUM_PROTOCOL
+/**
+  * @brief  Requests the host to resend its stream from the given line number on. Pushed before the
+            error response of the first rejected line.
+  * @param  uint32_t line_number
+  * @retval None
+  */
+void report_resend_request(uint32_t line_number) {
+  printString("[RS:\t");
+  print_uint32_base10(line_number);
+  report_util_feedback_line_feed();
+}
+#endif
+
 /**
   * @brief  Welcome message
   * @param  None
@@ -202,6 +217,7 @@ void report_grbl_settings(void) {
     report_util_float_setting(11,settings.junction_deviation,N_DECIMAL_SETTINGVALUE);
     report_util_float_setting(12,settings.arc_tolerance,N_DECIMAL_SETTINGVALUE);
     report_util_uint8_setting(13,bit_istrue(settings.flags,BITFLAG_REPORT_INCHES));
+    report_util_float_setting(15,settings.status_report_interval,0);
     report_util_uint8_setting(20,bit_istrue(settings.flags,BITFLAG_SOFT_LIMIT_ENABLE));
     report_util_uint8_setting(21,bit_istrue(settings.flags,BITFLAG_HARD_LIMIT_ENABLE));
     report_util_uint8_setting(22,bit_istrue(settings.flags,BITFLAG_HOMING_ENABLE));
@@ -227,6 +243,7 @@ void report_grbl_settings(void) {
                 case 1: report_util_float_setting( val + idx, settings.max_rate[idx], N_DECIMAL_SETTINGVALUE); break;
                 case 2: report_util_float_setting( val + idx, settings.acceleration[idx] / (60 * 60), N_DECIMAL_SETTINGVALUE); break;
                 case 3: report_util_float_setting( val + idx, -settings.max_travel[idx], N_DECIMAL_SETTINGVALUE); break;
+                case 4: report_util_float_setting( val + idx, settings.max_jerk[idx], N_DECIMAL_SETTINGVALUE); break;
             }
         }
         val += AXIS_SETTINGS_INCREMENT;
@@ -313,6 +330,15 @@ void report_gcode_modes(void) {
     report_util_gcode_modes_G();
     print_uint8_base10(94-gc_state.modal.feed_rate);
 
+    report_util_gcode_modes_G();
+    print_uint8_base10(98+gc_state.modal.retract);
+
+    report_util_gcode_modes_G();
+    print_uint8_base10(50+gc_state.modal.scaling);
+
+    report_util_gcode_modes_G();
+    print_uint8_base10(69-gc_state.modal.rotation);
+
     if (gc_state.modal.program_flow) {
         report_util_gcode_modes_M();
         switch (gc_state.modal.program_flow) {
@@ -394,6 +420,104 @@ void report_execute_startup_message(char *line, uint8_t status_code) {
     report_status_message(status_code);
 }
 
+#ifdef PROGRAM_STORE
+/**
+  * @brief  Prints a stored program, as [PRG:name,size].
+  * @param  char *name, zero-terminated, uint32_t size, bytes
+  * @retval None
+  */
+void report_program_entry(char *name, uint32_t size) {
+    printString("[PRG:\t");
+    while (*name != 0) { serial_write(*(name++)); }
+    serial_write(',');
+    print_uint32_base10(size);
+    report_util_feedback_line_feed();
+}
+#endif
+
+#ifdef PROGRAM_VALIDATION
+#ifdef PROGRAM_SIMULATION
+/**
+  * @brief  Prints a time given in stepper timer ticks as seconds, with three decimals.
+  * @param  uint64_t ticks
+  * @retval None
+  */
+static void report_util_ticks(uint64_t ticks) {
+    uint64_t ms = (ticks + VALIDATION_TICKS_PER_SECOND/2000) / (VALIDATION_TICKS_PER_SECOND/1000);
+    uint16_t fraction = ms % 1000;
+    print_uint32_base10((uint32_t)(ms / 1000));
+    serial_write('.');
+    serial_write('0' + fraction / 100);
+    serial_write('0' + (fraction / 10) % 10);
+    serial_write('0' + fraction % 10);
+}
+#endif
+
+/**
+  * @brief  Prints the summary of a validation:
+              [VAL:lines,errors,soft limit violations]
+              [VALERR:line,status]    for each failing line logged
+              [VALSL:line]            first motion beyond the soft limits, if any
+              [VALMIN:x,y,z]          extents in machine coordinates, if the job has motions
+              [VALMAX:x,y,z]
+              [SIM:seconds]           run time of a simulation
+  * @param  validation_summary_t *summary
+  * @retval None
+  */
+void report_validation_summary(validation_summary_t *summary) {
+    uint8_t idx;
+    printString("[VAL:\t");
+    print_uint32_base10(summary->lines);
+    serial_write(',');
+    print_uint32_base10(summary->errors);
+    serial_write(',');
+    print_uint32_base10(summary->soft_limit_count);
+    report_util_feedback_line_feed();
+    for (idx = 0; (idx < VALIDATION_ERROR_LOG) && (idx < summary->errors); idx++) {
+        printString("[VALERR:\t");
+        print_uint32_base10(summary->error_line[idx]);
+        serial_write(',');
+        print_uint8_base10(summary->error_status[idx]);
+        report_util_feedback_line_feed();
+    }
+    if (summary->soft_limit_count) {
+        printString("[VALSL:\t");
+        print_uint32_base10(summary->soft_limit_line);
+        report_util_feedback_line_feed();
+    }
+    if (summary->motion) {
+        printString("[VALMIN:\t");
+        report_util_axis_values(summary->min);
+        report_util_feedback_line_feed();
+        printString("[VALMAX:\t");
+        report_util_axis_values(summary->max);
+        report_util_feedback_line_feed();
+    }
+    #ifdef PROGRAM_SIMULATION
+      if (summary->simulated) {
+          printString("[SIM:\t");
+          report_util_ticks(summary->ticks);
+          report_util_feedback_line_feed();
+      }
+    #endif
+}
+
+#ifdef PROGRAM_SIMULATION
+/**
+  * @brief  Prints the run time of a line of a simulation, as [SIML:line,seconds].
+  * @param  uint32_t line, uint64_t ticks, stepper timer ticks
+  * @retval None
+  */
+void report_simulation_line(uint32_t line, uint64_t ticks) {
+    printString("[SIML:\t");
+    print_uint32_base10(line);
+    serial_write(',');
+    report_util_ticks(ticks);
+    report_util_feedback_line_feed();
+}
+#endif
+#endif
+
 /**
   * @brief  Prints build info line
   * @param  char *line
@@ -443,6 +567,33 @@ void report_build_info(char *line) {
     #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
       serial_write('R');
     #endif
+    #ifdef JUNCTION_JERK_MODEL
+      serial_write('J');
+    #endif
+    #ifdef BINARY_MOTION_PROTOCOL
+      serial_write('B');
+    #endif
+    #ifdef REPORT_BINARY_STATUS
+      serial_write('Q');
+    #endif
+    #ifdef LINE_CHECKSUM_PROTOCOL
+      serial_write('K');
+    #endif
+    #ifdef OWORD_SUBROUTINES
+      serial_write('O');
+    #endif
+    #ifdef PROGRAM_STORE
+      serial_write('F');
+    #endif
+    #ifdef PARAMETRIC_GCODE
+      serial_write('X');
+    #endif
+    #ifdef PROGRAM_VALIDATION
+      serial_write('G');
+    #endif
+    #ifdef PROGRAM_SIMULATION
+      serial_write('U');
+    #endif
     #ifndef HOMING_INIT_LOCK
       serial_write('L');
     #endif
@@ -471,7 +622,7 @@ void report_build_info(char *line) {
     serial_write(',');
     print_uint8_base10(BLOCK_BUFFER_SIZE-1);
     serial_write(',');
-    print_uint8_base10(RX_BUFFER_SIZE);
+    print_uint32_base10(RX_BUFFER_SIZE);
 
     report_util_feedback_line_feed();
 }
@@ -494,10 +645,12 @@ void report_echo_line_received(char *line) {
             specific needs, but the desired real-time data report must be as short as possible. This is
             requires as it minimizes the computational overhead and allows grbl to keep running smoothly,
             especially during g-code programs with fast, short line segments and high frequency reports (5-20Hz).
-  * @param  None
+            Pushed reports carry the WCO and Ov fields only when these have changed, queried
+            reports also refresh them periodically.
+  * @param  uint8_t pushed, true for a report pushed at the auto report interval
   * @retval None
   */
-void report_realtime_status(void) {
+static void report_util_realtime_status(uint8_t pushed) {
     /* copy current state of the system position variable */
     int32_t current_position[N_AXIS];
     memcpy(current_position, sys_position, sizeof(sys_position));
@@ -506,6 +659,8 @@ void report_realtime_status(void) {
     system_convert_array_steps_to_mpos(print_position,current_position);
 
     /* report current machine state and sub-states */
+    sys.report_last_state = sys.state;
+    sys.report_last_suspend = sys.suspend;
     serial_write('<');
     switch (sys.state) {
       case STATE_IDLE:
@@ -519,6 +674,7 @@ void report_realtime_status(void) {
           else { serial_write('1'); } // Actively holding
           break;
         } // Continues to print jog state during jog cancel.
+        // Falls through.
       case STATE_JOG: printString("Jog\t"); break;
       case STATE_HOMING: printString("Home\t"); break;
       case STATE_ALARM: printString("Alarm\t"); break;
@@ -546,12 +702,9 @@ void report_realtime_status(void) {
     if (bit_isfalse(settings.status_report_mask, BITFLAG_RT_STATUS_POSITION_TYPE) || (sys.report_wco_counter == 0) ) {
         /* */
         for (uint8_t idx = 0; idx < N_AXIS; idx++) {
-            /* apply work coordinate offsets and tool length offset to current position */
-            wco[idx] = gc_state.coord_system[idx] + gc_state.coord_offset[idx];
+            /* work coordinate offsets and tool length offset, summed by the parser */
+            wco[idx] = gc_state.transform.work_offset[idx];
             /* */
-            if (idx == TOOL_LENGTH_OFFSET_AXIS) {
-                wco[idx] += gc_state.tool_length_offset;
-            }
             if (bit_isfalse(settings.status_report_mask,BITFLAG_RT_STATUS_POSITION_TYPE)) {
                 print_position[idx] -= wco[idx];
             }
@@ -572,7 +725,7 @@ void report_realtime_status(void) {
         printString("|Bf:\t");
         print_uint8_base10(plan_get_block_buffer_available());
         serial_write(',');
-        print_uint8_base10(serial_get_rx_buffer_available());
+        print_uint32_base10(serial_get_rx_buffer_available());
       }
     #endif
 
@@ -627,19 +780,21 @@ void report_realtime_status(void) {
     #endif
 
     #ifdef REPORT_FIELD_WORK_COORD_OFFSET
-      if (sys.report_wco_counter > 0) { sys.report_wco_counter--; }
+      // NOTE: A change sets the counter to zero. Pushed reports do not count down, so these only
+      // carry the field upon a change.
+      if (sys.report_wco_counter > 0) { if (!pushed) { sys.report_wco_counter--; } }
       else {
         if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
           sys.report_wco_counter = (REPORT_WCO_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
         } else { sys.report_wco_counter = (REPORT_WCO_REFRESH_IDLE_COUNT-1); }
-        if (sys.report_ovr_counter == 0) { sys.report_ovr_counter = 1; } // Set override on next report.
+        if (!pushed && (sys.report_ovr_counter == 0)) { sys.report_ovr_counter = 1; } // Set override on next report.
         printString("|WCO:\t");
         report_util_axis_values(wco);
       }
     #endif
 
     #ifdef REPORT_FIELD_OVERRIDES
-      if (sys.report_ovr_counter > 0) { sys.report_ovr_counter--; }
+      if (sys.report_ovr_counter > 0) { if (!pushed) { sys.report_ovr_counter--; } }
       else {
         if (sys.state & (STATE_HOMING | STATE_CYCLE | STATE_HOLD | STATE_JOG | STATE_SAFETY_DOOR)) {
           sys.report_ovr_counter = (REPORT_OVR_REFRESH_BUSY_COUNT-1); // Reset counter for slow refresh
@@ -680,6 +835,62 @@ void report_realtime_status(void) {
     report_util_line_feed();
 }
 
+/**
+  * @brief  Prints the real-time status report upon the '?' realtime command.
+  * @param  None
+  * @retval None
+  */
+void report_realtime_status(void) {
+    report_util_realtime_status(false);
+}
+
+/**
+  * @brief  Prints the real-time status report pushed at the $15 auto report interval, or upon a state
+            change.
+  * @param  None
+  * @retval None
+  */
+void report_realtime_status_pushed(void) {
+    report_util_realtime_status(true);
+}
+
+#ifdef REPORT_BINARY_STATUS
+/**
+  * @brief  Sends the binary status frame, the compact counterpart of report_realtime_status().
+            See report.h for the frame layout.
+  * @param  None
+  * @retval None
+  */
+void report_realtime_status_binary(void) {
+    uint8_t frame[REPORT_STATUS_PAYLOAD_LENGTH + 5];
+    uint8_t *payload = &frame[3];
+    uint16_t rx_available = serial_get_rx_buffer_available();
+    /* */
+    frame[0] = REPORT_STATUS_FRAME_START;
+    frame[1] = REPORT_STATUS_PAYLOAD_LENGTH;
+    frame[2] = REPORT_STATUS_FRAME_TYPE;
+    payload[0] = sys.state;
+    payload[1] = sys.suspend;
+    memcpy(&payload[2], sys_position, sizeof(sys_position));
+    payload[2 + 4*N_AXIS] = plan_get_block_buffer_available();
+    payload[3 + 4*N_AXIS] = rx_available & 0xFF;
+    payload[4 + 4*N_AXIS] = rx_available >> 8;
+    payload[5 + 4*N_AXIS] = sys.f_override;
+    payload[6 + 4*N_AXIS] = sys.r_override;
+    payload[7 + 4*N_AXIS] = sys.spindle_speed_ovr;
+    payload[8 + 4*N_AXIS] = limits_get_state();
+    payload[9 + 4*N_AXIS] = system_control_get_state();
+    payload[10 + 4*N_AXIS] = probe_get_state();
+    /* */
+    uint16_t crc = crc16_ccitt(&frame[1], REPORT_STATUS_PAYLOAD_LENGTH + 2);
+    frame[REPORT_STATUS_PAYLOAD_LENGTH + 3] = crc & 0xFF;
+    frame[REPORT_STATUS_PAYLOAD_LENGTH + 4] = crc >> 8;
+    /* */
+    serial_write_block(frame, sizeof(frame));
+    serial_tx_flush();
+}
+#endif
+
 
 /******************************************************************************
       END FILE
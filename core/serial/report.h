@@ -14,6 +14,10 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "config.h"
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
 
 /* Exported define -----------------------------------------------------------*/
 
@@ -56,6 +60,37 @@
 #define STATUS_GCODE_UNUSED_WORDS 36
 #define STATUS_GCODE_G43_DYNAMIC_AXIS_ERROR 37
 #define STATUS_GCODE_MAX_VALUE_EXCEEDED 38
+/* */
+#define STATUS_BINARY_FRAME_CRC 39
+#define STATUS_BINARY_FRAME_INVALID 40
+#define STATUS_LINE_CHECKSUM 41
+#define STATUS_LINE_SEQUENCE 42
+#define STATUS_GCODE_CANNED_CYCLE 43
+#define STATUS_OWORD_INVALID 44
+#define STATUS_OWORD_UNDEFINED 45
+#define STATUS_OWORD_CACHE_FULL 46
+#define STATUS_PROGRAM_NOT_FOUND 47
+#define STATUS_PROGRAM_STORAGE_FULL 48
+#define STATUS_PROGRAM_STORAGE_FAIL 49
+#define STATUS_EXPRESSION_INVALID 50
+#define STATUS_EXPRESSION_PARAMETER 51
+#define STATUS_EXPRESSION_MATH 52
+#define STATUS_GCODE_TRANSFORM 53
+/* Binary status frame, all multi-byte values little endian:
+     [STX][LEN][TYPE][PAYLOAD, LEN bytes][CRC low][CRC high]
+   The CRC is a CRC-16/CCITT (poly 0x1021, init 0xFFFF) over LEN, TYPE and PAYLOAD, the same framing
+   as the binary motion protocol. Payload offsets in bytes:
+     0        uint8    sys.state, STATE_ bitmask
+     1        uint8    sys.suspend, SUSPEND_ bitmask
+     2        int32    machine position in steps, N_AXIS values
+     2+4*N    uint8    available planner blocks
+     3+4*N    uint16   available serial RX buffer bytes
+     5+4*N    uint8    feed, rapid and spindle override values in percent
+     8+4*N    uint8    limit, control and probe pin states */
+#define REPORT_STATUS_FRAME_START     0x02
+#define REPORT_STATUS_FRAME_TYPE      0x81
+#define REPORT_STATUS_PAYLOAD_LENGTH  (11 + 4*N_AXIS)
+
 /* define Grbl alarm codes, valid values (1-255), 0 is reserved */
 #define ALARM_HARD_LIMIT_ERROR      EXEC_ALARM_HARD_LIMIT
 #define ALARM_SOFT_LIMIT_ERROR      EXEC_ALARM_SOFT_LIMIT
@@ -86,17 +121,33 @@
 extern void report_status_message(uint8_t status_code);
 extern void report_alarm_message(uint8_t alarm_code);
 extern void report_feedback_message(uint8_t message_code);
+#ifdef LINE_CHECKSUM_PROTOCOL
+  extern void report_resend_request(uint32_t line_number);
+#endif
 extern void report_init_message();
 extern void report_grbl_help();
 extern void report_grbl_settings();
 extern void report_echo_line_received(char *line);
 extern void report_realtime_status();
+extern void report_realtime_status_pushed(void);
+#ifdef REPORT_BINARY_STATUS
+  extern void report_realtime_status_binary(void);
+#endif
 extern void report_probe_parameters();
 extern void report_ngc_parameters();
 extern void report_gcode_modes();
 extern void report_startup_line(uint8_t n, char *line);
 extern void report_execute_startup_message(char *line, uint8_t status_code);
 extern void report_build_info(char *line);
+#ifdef PROGRAM_STORE
+  extern void report_program_entry(char *name, uint32_t size);
+#endif
+#ifdef PROGRAM_VALIDATION
+  extern void report_validation_summary(validation_summary_t *summary);
+  #ifdef PROGRAM_SIMULATION
+    extern void report_simulation_line(uint32_t line, uint64_t ticks);
+  #endif
+#endif
 #ifdef DEBUG
   extern void report_realtime_debug();
 #endif
@@ -9,43 +9,164 @@
 **/
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "system.h"
 #include "config.h"
 #include "serial.h"
 #include "motion_control.h"
 #include "hal_abstract.h"
+#ifdef BINARY_MOTION_PROTOCOL
+  #include "binary_protocol.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
-/* Private define ------------------------------------------------------------*/
-#ifndef RX_BUFFER_SIZE
+#define RX_RING_BUFFER (RX_BUFFER_SIZE + 1)
+#define TX_RING_BUFFER (TX_BUFFER_SIZE + 1)
 
-#endif
+/* NOTE: Ring indices are 16-bit, each is written by one side only. 16-bit loads and stores are
+   single, atomic accesses on the supported 32-bit cores */
+typedef struct {
+    uint8_t rx_buffer[RX_RING_BUFFER];
+    volatile uint16_t rx_head;
+    volatile uint16_t rx_tail;
+    uint8_t tx_buffer[TX_RING_BUFFER];
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
+    volatile uint16_t tx_in_flight;   // Length of the HAL transfer started at the tail, 0 if idle
+} serial_channel_t;
 
-#define RX_RING_BUFFER (RX_BUFFER_SIZE + 1)
-// #define TX_RING_BUFFER (TX_BUFFER_SIZE + 1)
+/* Private define ------------------------------------------------------------*/
+/* binary frame start seen, its length byte is next */
+#define RX_FRAME_AWAIT_LENGTH 0xFFFF
 
 /* Private macro -------------------------------------------------------------*/
+/* Realtime command characters are picked off the stream, all others go to the RX ring buffer */
+#define RX_IS_REALTIME(c)       ( ((c) == CMD_STATUS_REPORT) || ((c) == CMD_CYCLE_START) || \
+                                  ((c) == CMD_FEED_HOLD) || ((c) == CMD_RESET) || ((c) > 0x7F) )
+/* Word-at-a-time helpers, see _rx_word_has_realtime() */
+#define RX_WORD_BROADCAST(c)    ((uint32_t)(c) * 0x01010101UL)
+#define RX_WORD_HAS_ZERO(w)     (((w) - 0x01010101UL) & ~(w))
 /* Private variables ---------------------------------------------------------*/
-uint8_t serial_rx_buffer[RX_RING_BUFFER];
-uint8_t serial_rx_buffer_head = 0;
-volatile uint8_t serial_rx_buffer_tail = 0;
+static serial_channel_t serial_channels[SERIAL_CHANNELS];
+static uint8_t serial_read_channel = SERIAL_CHANNEL_MAIN;   // Channel read by the main program
+static uint8_t serial_output = SERIAL_OUTPUT_ALL;           // Channels written by the main program
+static volatile uint8_t serial_report_requests[SERIAL_REQUEST_COUNT]; // Requesting channels, per request
+
+#ifdef BINARY_MOTION_PROTOCOL
+  static uint16_t rx_frame_remaining = 0;   // Bytes of a main channel binary frame still to pass unfiltered
+#endif
 
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Starts a HAL bulk transfer of the contiguous data at the TX ring tail, if the HAL is idle.
+            The wrapped rest, and anything written meanwhile, is sent from the completion callback.
+  * @param  uint8_t channel
+  * @retval None
+  */
+static void _tx_start(uint8_t channel) {
+    serial_channel_t *ch = &serial_channels[channel];
+    uint16_t tail = ch->tx_tail;
+    uint16_t head = ch->tx_head;
+    /* */
+    if ((ch->tx_in_flight != 0) || (head == tail)) {
+        return;
+    }
+    ch->tx_in_flight = (head > tail) ? (head - tail) : (TX_RING_BUFFER - tail);
+    #if (SERIAL_CHANNELS > 1)
+      if (channel != SERIAL_CHANNEL_MAIN) {
+          ngrbl_hal_serial_channel_write(channel, &ch->tx_buffer[tail], ch->tx_in_flight);
+          return;
+      }
+    #endif
+    ngrbl_hal_serial_write(&ch->tx_buffer[tail], ch->tx_in_flight);
+}
+
+/**
+  * @brief  Writes one byte to the TX ring buffer of a channel, waits while it is full.
+  * @param  uint8_t channel, data byte
+  * @retval None
+  */
+static void _tx_write(uint8_t channel, uint8_t data) {
+    serial_channel_t *ch = &serial_channels[channel];
+    uint16_t next_head = ch->tx_head + 1;
+    if (next_head == TX_RING_BUFFER) {
+        next_head = 0;
+    }
+    /* Wait until there is space in the buffer */
+    while (next_head == ch->tx_tail) {
+        _tx_start(channel);
+        /* Only check for abort to avoid an endless loop. */
+        if (sys_rt_exec_state & EXEC_RESET) {
+            return;
+        }
+    }
+    /* Store data and advance head */
+    ch->tx_buffer[ch->tx_head] = data;
+    ch->tx_head = next_head;
+    /* */
+    if (data == '\n') {
+        _tx_start(channel);
+    }
+}
+
+/**
+  * @brief  Writes a block of bytes to the TX ring buffer of a channel with at most two copies, one
+            up to the end of the ring and one for the wrapped rest. Falls back to _tx_write() when
+            the buffer has not enough space.
+  * @param  uint8_t channel, uint8_t *data, uint16_t length
+  * @retval None
+  */
+static void _tx_write_block(uint8_t channel, const uint8_t *data, uint16_t length) {
+    serial_channel_t *ch = &serial_channels[channel];
+    uint16_t head = ch->tx_head;
+    uint16_t tail = ch->tx_tail;
+    uint16_t free_space = (head >= tail) ? (TX_BUFFER_SIZE - (head - tail)) : (tail - head - 1);
+    /* */
+    if (length > free_space) {
+        while (length--) {
+            _tx_write(channel, *data++);
+        }
+        return;
+    }
+    /* copy up to the end of the ring, then the wrapped rest */
+    uint16_t first = TX_RING_BUFFER - head;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(&ch->tx_buffer[head], data, first);
+    if (length != first) {
+        memcpy(&ch->tx_buffer[0], data + first, length - first);
+    }
+    head += length;
+    if (head >= TX_RING_BUFFER) {
+        head -= TX_RING_BUFFER;
+    }
+    ch->tx_head = head;
+    /* */
+    if (memchr(data, '\n', length) != NULL) {
+        _tx_start(channel);
+    }
+}
+
 /* Functions -----------------------------------------------------------------*/
 
 /**
-  * @brief  Returns the number of bytes available in the RX serial buffer.
+  * @brief  Returns the number of bytes available in the RX serial buffer of the main channel, the
+            one streamed by the host.
   * @param  None
   * @retval The number of bytes available in the RX serial buffer.
   */
-uint8_t serial_get_rx_buffer_available(void) {
+uint16_t serial_get_rx_buffer_available(void) {
     /* Copy to limit multiple calls to volatile */
-    uint8_t rtail = serial_rx_buffer_tail;
-    if (serial_rx_buffer_head >= rtail) {
-        return (RX_BUFFER_SIZE - (serial_rx_buffer_head - rtail));
+    uint16_t rtail = serial_channels[SERIAL_CHANNEL_MAIN].rx_tail;
+    uint16_t rhead = serial_channels[SERIAL_CHANNEL_MAIN].rx_head;
+    if (rhead >= rtail) {
+        return (RX_BUFFER_SIZE - (rhead - rtail));
     }
-    return (rtail - serial_rx_buffer_head - 1);
+    return (rtail - rhead - 1);
 }
 
 /**
@@ -58,62 +179,204 @@ void serial_init(void) {
 }
 
 /**
-  * @brief  Writes one byte to the TX serial buffer. Called by main program.
+  * @brief  Selects the channel read by serial_read(), serial_get_rx_span() and serial_consume_rx(),
+            and routes the output to it, so responses go back where the command came from.
+  * @param  uint8_t channel, below SERIAL_CHANNELS
+  * @retval None
+  */
+void serial_select_channel(uint8_t channel) {
+    serial_read_channel = channel;
+    serial_output = bit(channel);
+}
+
+/**
+  * @brief  Returns the channel selected by serial_select_channel().
+  * @param  None
+  * @retval uint8_t channel
+  */
+uint8_t serial_get_channel(void) {
+    return serial_read_channel;
+}
+
+/**
+  * @brief  Routes the output of serial_write() and serial_write_block() to a set of channels.
+  * @param  uint8_t channel_mask, bit per channel, SERIAL_OUTPUT_ALL to broadcast
+  * @retval uint8_t previous channel mask, to restore the routing
+  */
+uint8_t serial_set_output(uint8_t channel_mask) {
+    uint8_t previous = serial_output;
+    serial_output = channel_mask;
+    return previous;
+}
+
+/**
+  * @brief  Returns and clears the channels that issued a report request since the last call.
+  * @param  uint8_t request, SERIAL_REQUEST_STATUS or SERIAL_REQUEST_STATUS_BINARY
+  * @retval uint8_t channel mask, SERIAL_OUTPUT_ALL if no channel is recorded
+  */
+uint8_t serial_take_report_requests(uint8_t request) {
+    /* the realtime command callbacks may add a channel meanwhile */
+    ngrbl_hal_critical_enter();
+    uint8_t channels = serial_report_requests[request];
+    serial_report_requests[request] = 0;
+    ngrbl_hal_critical_exit();
+    return (channels != 0) ? channels : SERIAL_OUTPUT_ALL;
+}
+
+/**
+  * @brief  Writes one byte to the TX serial buffer of each output channel. Called by main program.
+            The buffer is handed to the HAL in bulk at each line end, or when it runs full.
   * @param  data byte
   * @retval None
   */
 void serial_write(uint8_t data) {
-    ngrbl_hal_serial_write_byte(data);
+    for (uint8_t channel = 0; channel < SERIAL_CHANNELS; channel++) {
+        if (serial_output & bit(channel)) {
+            _tx_write(channel, data);
+        }
+    }
 }
 
 /**
-  * @brief  Fetches the first byte in the serial read buffer. Called by main program.
+  * @brief  Writes a block of bytes to the TX serial buffer of each output channel. Called by main
+            program.
+  * @param  uint8_t *data, uint16_t length
+  * @retval None
+  */
+void serial_write_block(const uint8_t *data, uint16_t length) {
+    for (uint8_t channel = 0; channel < SERIAL_CHANNELS; channel++) {
+        if (serial_output & bit(channel)) {
+            _tx_write_block(channel, data, length);
+        }
+    }
+}
+
+/**
+  * @brief  Hands any pending TX buffer data of all channels to the HAL.
+  * @param  None
+  * @retval None
+  */
+void serial_tx_flush(void) {
+    for (uint8_t channel = 0; channel < SERIAL_CHANNELS; channel++) {
+        _tx_start(channel);
+    }
+}
+
+/**
+  * @brief  Fetches the first byte in the serial read buffer of the selected channel. Called by main
+            program.
   * @param  None
   * @retval data byte
   */
 uint8_t serial_read(void) {
-    /* Temporary serial_rx_buffer_tail (to optimize for volatile) */
-    uint8_t tail = serial_rx_buffer_tail;
+    serial_channel_t *ch = &serial_channels[serial_read_channel];
+    /* Temporary tail (to optimize for volatile) */
+    uint16_t tail = ch->rx_tail;
     uint8_t data;
     /* */
-    if (serial_rx_buffer_head == tail) {
+    if (ch->rx_head == tail) {
         return SERIAL_NO_DATA;
     }
     else {
-        data = serial_rx_buffer[tail];
+        data = ch->rx_buffer[tail];
         tail++;
         if (tail == RX_RING_BUFFER) {
             tail = 0;
         }
-        serial_rx_buffer_tail = tail;
+        ch->rx_tail = tail;
         return data;
     }
 }
 
 /**
-  * @brief  ngrbl_hal_serial_rx_callback
-  * @param  rx byte data
+  * @brief  Gives direct access to the unread RX buffer data of the selected channel. The span is
+            contiguous and ends at the buffer head or at the end of the ring, whichever comes first.
+            Called by main program.
+            NOTE: The data stays owned by the reader until released by serial_consume_rx() and may
+            be modified in place, the RX interrupt only writes outside of it.
+  * @param  uint8_t **data, set to the first unread byte
+  * @retval Number of contiguous bytes available
+  */
+uint16_t serial_get_rx_span(uint8_t **data) {
+    serial_channel_t *ch = &serial_channels[serial_read_channel];
+    uint16_t tail = ch->rx_tail;
+    uint16_t head = ch->rx_head;
+    /* */
+    *data = &ch->rx_buffer[tail];
+    if (head >= tail) {
+        return (head - tail);
+    }
+    return (RX_RING_BUFFER - tail);
+}
+
+/**
+  * @brief  Releases data read through serial_get_rx_span(). Called by main program.
+  * @param  uint16_t length, not more than the span returned
+  * @retval None
+  */
+void serial_consume_rx(uint16_t length) {
+    serial_channel_t *ch = &serial_channels[serial_read_channel];
+    uint16_t tail = ch->rx_tail + length;
+    if (tail >= RX_RING_BUFFER) {
+        tail -= RX_RING_BUFFER;
+    }
+    ch->rx_tail = tail;
+}
+
+/**
+  * @brief  Drops the unread data of all channels and routes the output to all channels.
+  * @param  None
   * @retval None
   */
 void serial_reset_read_buffer(void) {
-    serial_rx_buffer_tail = serial_rx_buffer_head;
+    for (uint8_t channel = 0; channel < SERIAL_CHANNELS; channel++) {
+        serial_channels[channel].rx_tail = serial_channels[channel].rx_head;
+    }
+    serial_read_channel = SERIAL_CHANNEL_MAIN;
+    serial_output = SERIAL_OUTPUT_ALL;
+    #ifdef BINARY_MOTION_PROTOCOL
+      rx_frame_remaining = 0;
+    #endif
 }
 
 
 /* RX/TX callback function ---------------------------------------------------*/
 
 /**
-  * @brief  _store_handle_data_in
-  * @param  rx byte data
+  * @brief  ngrbl_hal_serial_channel_tx_callback. Called by the HAL once a transfer of the channel is
+            complete, releases the sent data and continues with any pending data.
+  * @param  uint8_t channel
   * @retval None
   */
-static void _store_handle_data_in(uint8_t data) {
-    /* */
-    uint8_t next_head;
+void ngrbl_hal_serial_channel_tx_callback(uint8_t channel) {
+    serial_channel_t *ch = &serial_channels[channel];
+    uint16_t tail = ch->tx_tail + ch->tx_in_flight;
+    if (tail >= TX_RING_BUFFER) {
+        tail -= TX_RING_BUFFER;
+    }
+    ch->tx_tail = tail;
+    ch->tx_in_flight = 0;
+    _tx_start(channel);
+}
 
-    /* Pick off realtime command characters directly from the serial stream. These characters are
-       not passed into the main buffer, but these set system state flag bits for realtime execution.
-    */
+/**
+  * @brief  ngrbl_hal_serial_tx_callback. Called by the HAL once a ngrbl_hal_serial_write() transfer
+            of the main channel is complete.
+  * @param  None
+  * @retval None
+  */
+void ngrbl_hal_serial_tx_callback(void) {
+    ngrbl_hal_serial_channel_tx_callback(SERIAL_CHANNEL_MAIN);
+}
+
+/**
+  * @brief  Executes a realtime command character picked off the serial stream. These characters are
+            not passed into the main buffer, but these set system state flag bits for realtime execution.
+            Any unfound extended-ASCII character is thrown away.
+  * @param  uint8_t channel, rx byte data, one of RX_IS_REALTIME()
+  * @retval None
+  */
+static void _execute_realtime_command(uint8_t channel, uint8_t data) {
     switch (data) {
 
         /* Call motion control reset routine.*/
@@ -122,6 +385,7 @@ static void _store_handle_data_in(uint8_t data) {
         break;
         /* Set as true */
         case CMD_STATUS_REPORT:
+            serial_report_requests[SERIAL_REQUEST_STATUS] |= bit(channel);
             system_set_exec_state_flag(EXEC_STATUS_REPORT);
         break;
         /* Set as true */
@@ -132,71 +396,164 @@ static void _store_handle_data_in(uint8_t data) {
         case CMD_FEED_HOLD:
             system_set_exec_state_flag(EXEC_FEED_HOLD);
         break;
-        /* */
-        default:
-            if (data > 0x7F) { // Real-time control characters are extended ACSII only.
-                switch(data) {
-                    /* Set as true */
-                    case CMD_SAFETY_DOOR: system_set_exec_state_flag(EXEC_SAFETY_DOOR); break;
-                    /* Block all other states from invoking motion cancel. */
-                    case CMD_JOG_CANCEL:
-                        if (sys.state & STATE_JOG) {
-                            system_set_exec_state_flag(EXEC_MOTION_CANCEL);
-                        }
-                    break;
-                    /* debug */
-                    #ifdef DEBUG
-                    case CMD_DEBUG_REPORT: { uint8_t sreg = SREG; cli(); bit_true(sys_rt_exec_debug,EXEC_DEBUG_REPORT); SREG = sreg; } break;
-                    #endif
-                    /* */
-                    case CMD_FEED_OVR_RESET: system_set_exec_motion_override_flag(EXEC_FEED_OVR_RESET); break;
-                    case CMD_FEED_OVR_COARSE_PLUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_PLUS); break;
-                    case CMD_FEED_OVR_COARSE_MINUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_MINUS); break;
-                    case CMD_FEED_OVR_FINE_PLUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_PLUS); break;
-                    case CMD_FEED_OVR_FINE_MINUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_MINUS); break;
-                    case CMD_RAPID_OVR_RESET: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_RESET); break;
-                    case CMD_RAPID_OVR_MEDIUM: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_MEDIUM); break;
-                    case CMD_RAPID_OVR_LOW: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_LOW); break;
-                    case CMD_SPINDLE_OVR_RESET: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_RESET); break;
-                    case CMD_SPINDLE_OVR_COARSE_PLUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_COARSE_PLUS); break;
-                    case CMD_SPINDLE_OVR_COARSE_MINUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_COARSE_MINUS); break;
-                    case CMD_SPINDLE_OVR_FINE_PLUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_FINE_PLUS); break;
-                    case CMD_SPINDLE_OVR_FINE_MINUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_FINE_MINUS); break;
-                    case CMD_SPINDLE_OVR_STOP: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_STOP); break;
-                    case CMD_COOLANT_FLOOD_OVR_TOGGLE: system_set_exec_accessory_override_flag(EXEC_COOLANT_FLOOD_OVR_TOGGLE); break;
-                    #ifdef ENABLE_M7
-                      case CMD_COOLANT_MIST_OVR_TOGGLE: system_set_exec_accessory_override_flag(EXEC_COOLANT_MIST_OVR_TOGGLE); break;
-                    #endif
-                }
-                // Throw away any unfound extended-ASCII character by not passing it to the serial buffer.
-            }
-            else {
-                /* Write character to buffer */
-                next_head = serial_rx_buffer_head + 1;
-                if (next_head == RX_RING_BUFFER) {
-                    next_head = 0;
-                }
-                /* Write data to buffer unless it is full. */
-                if (next_head != serial_rx_buffer_tail) {
-                    serial_rx_buffer[serial_rx_buffer_head] = data;
-                    serial_rx_buffer_head = next_head;
-                }
+        /* Set as true */
+        case CMD_SAFETY_DOOR: system_set_exec_state_flag(EXEC_SAFETY_DOOR); break;
+        /* Block all other states from invoking motion cancel. */
+        case CMD_JOG_CANCEL:
+            if (sys.state & STATE_JOG) {
+                system_set_exec_state_flag(EXEC_MOTION_CANCEL);
             }
-        break; // default
+        break;
+        /* debug */
+        #ifdef DEBUG
+        case CMD_DEBUG_REPORT: { uint8_t sreg = SREG; cli(); bit_true(sys_rt_exec_debug,EXEC_DEBUG_REPORT); SREG = sreg; } break;
+        #endif
+        /* */
+        #ifdef REPORT_BINARY_STATUS
+        case CMD_STATUS_REPORT_BINARY:
+            serial_report_requests[SERIAL_REQUEST_STATUS_BINARY] |= bit(channel);
+            system_set_exec_report_flag(EXEC_BINARY_STATUS_REPORT);
+        break;
+        #endif
+        /* */
+        case CMD_FEED_OVR_RESET: system_set_exec_motion_override_flag(EXEC_FEED_OVR_RESET); break;
+        case CMD_FEED_OVR_COARSE_PLUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_PLUS); break;
+        case CMD_FEED_OVR_COARSE_MINUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_COARSE_MINUS); break;
+        case CMD_FEED_OVR_FINE_PLUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_PLUS); break;
+        case CMD_FEED_OVR_FINE_MINUS: system_set_exec_motion_override_flag(EXEC_FEED_OVR_FINE_MINUS); break;
+        case CMD_RAPID_OVR_RESET: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_RESET); break;
+        case CMD_RAPID_OVR_MEDIUM: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_MEDIUM); break;
+        case CMD_RAPID_OVR_LOW: system_set_exec_motion_override_flag(EXEC_RAPID_OVR_LOW); break;
+        case CMD_SPINDLE_OVR_RESET: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_RESET); break;
+        case CMD_SPINDLE_OVR_COARSE_PLUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_COARSE_PLUS); break;
+        case CMD_SPINDLE_OVR_COARSE_MINUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_COARSE_MINUS); break;
+        case CMD_SPINDLE_OVR_FINE_PLUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_FINE_PLUS); break;
+        case CMD_SPINDLE_OVR_FINE_MINUS: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_FINE_MINUS); break;
+        case CMD_SPINDLE_OVR_STOP: system_set_exec_accessory_override_flag(EXEC_SPINDLE_OVR_STOP); break;
+        case CMD_COOLANT_FLOOD_OVR_TOGGLE: system_set_exec_accessory_override_flag(EXEC_COOLANT_FLOOD_OVR_TOGGLE); break;
+        #ifdef ENABLE_M7
+          case CMD_COOLANT_MIST_OVR_TOGGLE: system_set_exec_accessory_override_flag(EXEC_COOLANT_MIST_OVR_TOGGLE); break;
+        #endif
+        /* */
+        default: break;
     }
 }
 
 /**
-  * @brief  ngrbl_hal_serial_rx_callback
-  * @param  rx byte data
+  * @brief  Writes a run of plain characters to the RX ring buffer with at most two copies, one up
+            to the end of the ring and one for the wrapped rest. Data that does not fit is dropped,
+            as the buffer is full.
+  * @param  serial_channel_t *ch, uint8_t *data, uint16_t length
   * @retval None
   */
-void ngrbl_hal_serial_rx_callback(uint8_t* data, uint16_t length) {
+static void _rx_buffer_write_block(serial_channel_t *ch, const uint8_t *data, uint16_t length) {
+    uint16_t head = ch->rx_head;
+    uint16_t tail = ch->rx_tail;
+    uint16_t free_space = (head >= tail) ? (RX_BUFFER_SIZE - (head - tail)) : (tail - head - 1);
+    /* */
+    if (length > free_space) {
+        length = free_space;
+    }
+    if (length == 0) {
+        return;
+    }
+    /* copy up to the end of the ring, then the wrapped rest */
+    uint16_t first = RX_RING_BUFFER - head;
+    if (first > length) {
+        first = length;
+    }
+    memcpy(&ch->rx_buffer[head], data, first);
+    if (length != first) {
+        memcpy(&ch->rx_buffer[0], data + first, length - first);
+    }
+    /* publish the new head once the data is in place */
+    head += length;
+    if (head >= RX_RING_BUFFER) {
+        head -= RX_RING_BUFFER;
+    }
+    ch->rx_head = head;
+}
+
+/**
+  * @brief  Checks four received bytes at once for realtime command characters: '?', '~', '!', 0x18
+            and any extended ASCII byte, plus the binary frame start if enabled. The byte-wise zero test of (word ^ pattern) tells exactly if
+            any byte matches, only not which one, so a flagged word is rechecked byte by byte.
+  * @param  uint8_t *data, four bytes, any alignment
+  * @retval true if the word may hold a realtime character
+  */
+static inline uint8_t _rx_word_has_realtime(const uint8_t *data) {
+    uint32_t w;
+    memcpy(&w, data, sizeof(w));
+    uint32_t mask = w |
+                    RX_WORD_HAS_ZERO(w ^ RX_WORD_BROADCAST(CMD_STATUS_REPORT)) |
+                    RX_WORD_HAS_ZERO(w ^ RX_WORD_BROADCAST(CMD_CYCLE_START)) |
+                    RX_WORD_HAS_ZERO(w ^ RX_WORD_BROADCAST(CMD_FEED_HOLD)) |
+                    RX_WORD_HAS_ZERO(w ^ RX_WORD_BROADCAST(CMD_RESET));
+    #ifdef BINARY_MOTION_PROTOCOL
+      mask |= RX_WORD_HAS_ZERO(w ^ RX_WORD_BROADCAST(BIN_FRAME_START));
+    #endif
+    return (mask & 0x80808080UL) != 0;
+}
+
+/**
+  * @brief  ngrbl_hal_serial_channel_rx_callback. Handles a whole chunk received on a channel: clean
+            words are skipped four bytes at a time, realtime characters are executed in stream order
+            and the plain runs in between are block copied into the RX ring buffer of the channel.
+            Binary frames of the main channel are copied unfiltered.
+  * @param  uint8_t channel, uint8_t* data, uint16_t length
+  * @retval None
+  */
+void ngrbl_hal_serial_channel_rx_callback(uint8_t channel, uint8_t* data, uint16_t length) {
+    serial_channel_t *ch = &serial_channels[channel];
+    uint16_t run_start = 0;
     uint16_t i = 0;
+    /* */
     while (i != length) {
-        _store_handle_data_in(data[i]);
+      #ifdef BINARY_MOTION_PROTOCOL
+        /* pass main channel frame bytes as they are, the payload may hold any value */
+        if ((channel == SERIAL_CHANNEL_MAIN) && (rx_frame_remaining != 0)) {
+            if (rx_frame_remaining == RX_FRAME_AWAIT_LENGTH) {
+                rx_frame_remaining = BIN_FRAME_TAIL_LENGTH(data[i]);
+                i++;
+            }
+            else {
+                uint16_t n = min(rx_frame_remaining, (uint16_t)(length - i));
+                rx_frame_remaining -= n;
+                i += n;
+            }
+            continue;
+        }
+      #endif
+        /* skip clean words */
+        while ( ((length - i) >= 4) && !_rx_word_has_realtime(&data[i]) ) {
+            i += 4;
+        }
+        if (i == length) {
+            break;
+        }
+        /* flagged word or tail, check byte by byte */
+        if (RX_IS_REALTIME(data[i])) {
+            _rx_buffer_write_block(ch, &data[run_start], i - run_start);
+            _execute_realtime_command(channel, data[i]);
+            run_start = i + 1;
+        }
+      #ifdef BINARY_MOTION_PROTOCOL
+        else if ((data[i] == BIN_FRAME_START) && (channel == SERIAL_CHANNEL_MAIN)) {
+            rx_frame_remaining = RX_FRAME_AWAIT_LENGTH;
+        }
+      #endif
         i++;
     }
+    _rx_buffer_write_block(ch, &data[run_start], length - run_start);
+}
+
+/**
+  * @brief  ngrbl_hal_serial_rx_callback. Handles a chunk received on the main channel.
+  * @param  uint8_t* data, uint16_t length
+  * @retval None
+  */
+void ngrbl_hal_serial_rx_callback(uint8_t* data, uint16_t length) {
+    ngrbl_hal_serial_channel_rx_callback(SERIAL_CHANNEL_MAIN, data, length);
 }
 
 
@@ -14,20 +14,52 @@
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "config.h"
 
 /* Exported define -----------------------------------------------------------*/
-#define RX_BUFFER_SIZE                ((uint8_t)128)
+#ifndef RX_BUFFER_SIZE
+  #define RX_BUFFER_SIZE              128
+#endif
+#ifndef TX_BUFFER_SIZE
+  #define TX_BUFFER_SIZE              128
+#endif
+
+#if (RX_BUFFER_SIZE > 65534) || (TX_BUFFER_SIZE > 65534)
+  #error "RX_BUFFER_SIZE and TX_BUFFER_SIZE must be 65534 or less"
+#endif
 #define SERIAL_NO_DATA 0xff
 
+#ifndef SERIAL_CHANNELS
+  #define SERIAL_CHANNELS             1
+#endif
+#if (SERIAL_CHANNELS < 1) || (SERIAL_CHANNELS > 8)
+  #error "SERIAL_CHANNELS must be 1 to 8"
+#endif
+#define SERIAL_CHANNEL_MAIN           0   // Program stream, has priority over the other channels
+#define SERIAL_OUTPUT_ALL             ((uint8_t)((1 << SERIAL_CHANNELS) - 1))
+
+/* serial_take_report_requests() requests */
+#define SERIAL_REQUEST_STATUS         0
+#define SERIAL_REQUEST_STATUS_BINARY  1
+#define SERIAL_REQUEST_COUNT          2
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported typedef ----------------------------------------------------------*/
 /* Exported variables --------------------------------------------------------*/
 /* Exported function ---------------------------------------------------------*/
 extern void serial_init(void);
+extern void serial_select_channel(uint8_t channel);
+extern uint8_t serial_get_channel(void);
+extern uint8_t serial_set_output(uint8_t channel_mask);
+extern uint8_t serial_take_report_requests(uint8_t request);
 extern void serial_write(uint8_t data);
+extern void serial_write_block(const uint8_t *data, uint16_t length);
+extern void serial_tx_flush(void);
 extern uint8_t serial_read(void);
+extern uint16_t serial_get_rx_span(uint8_t **data);
+extern void serial_consume_rx(uint16_t length);
 extern void serial_reset_read_buffer(void);
-extern uint8_t serial_get_rx_buffer_available(void);
+extern uint16_t serial_get_rx_buffer_available(void);
 
 
 #endif /* __GRBL_SERIAL__H */
@@ -0,0 +1,249 @@
+/**
+  ******************************************************************************
+  * @file    binary_protocol.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Framed binary motion protocol. Pre-parsed motions from the host go straight to
+             mc_line(), bypassing line assembly and the g-code parser.
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "binary_protocol.h"
+#include "system.h"
+#include "settings.h"
+#include "planner.h"
+#include "gcode.h"
+#include "report.h"
+#include "motion_control.h"
+#include "spindle_control.h"
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
+
+#ifdef BINARY_MOTION_PROTOCOL
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint8_t state;
+    uint8_t overflow;         // Payload length above BIN_FRAME_MAX_PAYLOAD, the frame is dropped
+    uint16_t index;           // Bytes received after STX
+    uint16_t length;          // Total bytes expected after STX
+    uint8_t data[BIN_FRAME_TAIL_LENGTH(BIN_FRAME_MAX_PAYLOAD) + 1];  // LEN, TYPE, PAYLOAD, CRC
+} bin_frame_t;
+
+/* Private define ------------------------------------------------------------*/
+#define BIN_STATE_IDLE        0
+#define BIN_STATE_LENGTH      1
+#define BIN_STATE_BODY        2
+#define BIN_STATE_RESYNC      3   // After a bad frame, bytes are dropped up to the next STX or line end
+
+#define BIN_LINE_CONDITION_MASK (PL_COND_FLAG_RAPID_MOTION|PL_COND_FLAG_NO_FEED_OVERRIDE|PL_COND_FLAG_INVERSE_TIME)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static bin_frame_t frame;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Executes a line motion frame payload.
+  * @param  uint8_t type, uint8_t *payload
+  * @retval uint8_t status code
+  */
+static uint8_t _execute_line(uint8_t type, const uint8_t *payload) {
+    plan_line_data_t plan_data;
+    float target[N_AXIS];
+    float spindle_speed;
+    /* */
+    memset(&plan_data, 0, sizeof(plan_line_data_t));
+    plan_data.condition = (payload[0] & BIN_LINE_CONDITION_MASK) | gc_state.modal.spindle | gc_state.modal.coolant;
+    #ifdef USE_LINE_NUMBERS
+      memcpy(&plan_data.line_number, &payload[1], sizeof(int32_t));
+    #endif
+    memcpy(&plan_data.feed_rate, &payload[5], sizeof(float));
+    memcpy(&spindle_speed, &payload[9], sizeof(float));
+    if (!(plan_data.condition & PL_COND_FLAG_RAPID_MOTION) && !(plan_data.feed_rate > 0.0f)) {
+        return STATUS_GCODE_UNDEFINED_FEED_RATE;
+    }
+    /* The spindle speed is set as by an S word of a motion line. In laser mode it goes with the
+       block instead of a sync, and rapids run with the laser off */
+    if ((int32_t)gc_state.spindle_speed != (int32_t)spindle_speed) {
+        if ((gc_state.modal.spindle != SPINDLE_DISABLE) && bit_isfalse(settings.flags, BITFLAG_LASER_MODE)) {
+            #ifdef VARIABLE_SPINDLE
+              spindle_sync(gc_state.modal.spindle, spindle_speed);
+            #else
+              spindle_sync(gc_state.modal.spindle, 0.0);
+            #endif
+        }
+        gc_state.spindle_speed = spindle_speed;
+    }
+    if (bit_isfalse(settings.flags, BITFLAG_LASER_MODE) || !(plan_data.condition & PL_COND_FLAG_RAPID_MOTION)) {
+        plan_data.spindle_speed = gc_state.spindle_speed;
+    }
+    /* */
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        if (type == BIN_FRAME_TYPE_LINE_STEPS) {
+            int32_t steps;
+            memcpy(&steps, &payload[13 + 4*idx], sizeof(int32_t));
+            target[idx] = steps/settings.steps_per_mm[idx];
+        }
+        else {
+            memcpy(&target[idx], &payload[13 + 4*idx], sizeof(float));
+        }
+    }
+    /* */
+    mc_line(target, &plan_data);
+    if (sys.abort) { return STATUS_OK; } // The motion has not been planned, the position stays
+    /* The parser position follows, so text g-code continues from the binary target */
+    memcpy(gc_state.position, target, sizeof(target));
+    return STATUS_OK;
+}
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  Drops any partially received frame. Called upon system reset.
+  * @param  None
+  * @retval None
+  */
+void binary_protocol_reset(void) {
+    frame.state = BIN_STATE_IDLE;
+}
+
+/**
+  * @brief  Feeds one byte read from the serial buffer to the frame assembly.
+  * @param  uint8_t c
+  * @retval BIN_FRAME_NONE, BIN_FRAME_PENDING or BIN_FRAME_COMPLETE
+  */
+uint8_t binary_protocol_process_byte(uint8_t c) {
+    switch (frame.state) {
+        /* */
+        case BIN_STATE_RESYNC:
+            if ((c == '\n') || (c == '\r')) {
+                frame.state = BIN_STATE_IDLE;
+                return BIN_FRAME_PENDING;
+            }
+            if (c != BIN_FRAME_START) {
+                return BIN_FRAME_PENDING;
+            }
+            frame.state = BIN_STATE_LENGTH;
+            frame.overflow = false;
+            frame.index = 0;
+        break;
+        /* */
+        case BIN_STATE_IDLE:
+            if (c != BIN_FRAME_START) {
+                return BIN_FRAME_NONE;
+            }
+            frame.state = BIN_STATE_LENGTH;
+            frame.overflow = false;
+            frame.index = 0;
+        break;
+        /* */
+        case BIN_STATE_LENGTH:
+            if (c > BIN_FRAME_MAX_PAYLOAD) {
+                /* a bad length, likely a lost byte, is reported at once and the stream resynced */
+                frame.overflow = true;
+                frame.state = BIN_STATE_RESYNC;
+                return BIN_FRAME_COMPLETE;
+            }
+            frame.length = 1 + BIN_FRAME_TAIL_LENGTH(c);
+            frame.data[frame.index++] = c;
+            frame.state = BIN_STATE_BODY;
+        break;
+        /* */
+        default:
+            frame.data[frame.index++] = c;
+            if (frame.index == frame.length) {
+                frame.state = BIN_STATE_IDLE;
+                return BIN_FRAME_COMPLETE;
+            }
+        break;
+    }
+    return BIN_FRAME_PENDING;
+}
+
+/**
+  * @brief  Tells if a frame is partially read, its remaining bytes must go to
+            binary_protocol_process_byte().
+  * @param  None
+  * @retval true while a frame is incomplete
+  */
+uint8_t binary_protocol_frame_pending(void) {
+    return (frame.state != BIN_STATE_IDLE);
+}
+
+/**
+  * @brief  Checks and executes the frame completed by binary_protocol_process_byte().
+  * @param  None
+  * @retval uint8_t status code, reported like the result of a text line
+  */
+uint8_t binary_protocol_execute_frame(void) {
+    /* */
+    if (frame.overflow) {
+        return STATUS_OVERFLOW;
+    }
+    uint8_t length = frame.data[0];
+    uint8_t type = frame.data[1];
+    uint16_t crc = frame.data[length + 2] | ((uint16_t)frame.data[length + 3] << 8);
+    if (crc != crc16_ccitt(frame.data, length + 2)) {
+        /* the frame length may be off by a lost byte, the next frame starts at the next STX */
+        frame.state = BIN_STATE_RESYNC;
+        return STATUS_BINARY_FRAME_CRC;
+    }
+    /* Same lockout as for text g-code */
+    if (sys.state & (STATE_ALARM | STATE_JOG)) {
+        return STATUS_SYSTEM_GC_LOCK;
+    }
+    /* */
+    switch (type) {
+        case BIN_FRAME_TYPE_LINE_MM:
+        case BIN_FRAME_TYPE_LINE_STEPS:
+            if (length != BIN_LINE_PAYLOAD_LENGTH) {
+                return STATUS_BINARY_FRAME_INVALID;
+            }
+            #ifdef PROGRAM_VALIDATION
+              if (validation_active()) {
+                  validation_line(_execute_line(type, &frame.data[2]));
+                  return STATUS_OK;
+              }
+            #endif
+            return _execute_line(type, &frame.data[2]);
+        /* */
+        #ifdef PROGRAM_VALIDATION
+          case BIN_FRAME_TYPE_VALIDATE_BEGIN:
+              if (length != 0) {
+                  return STATUS_BINARY_FRAME_INVALID;
+              }
+              if (sys.state != STATE_IDLE) {
+                  return STATUS_IDLE_ERROR;
+              }
+              validation_begin(VALIDATION_CHECK);
+              return STATUS_OK;
+          /* */
+          case BIN_FRAME_TYPE_VALIDATE_END:
+              if (length != 0) {
+                  return STATUS_BINARY_FRAME_INVALID;
+              }
+              if (!validation_active()) {
+                  return STATUS_INVALID_STATEMENT;
+              }
+              validation_end();
+              return STATUS_OK;
+        #endif
+        /* */
+        default:
+            return STATUS_BINARY_FRAME_INVALID;
+    }
+}
+
+#endif  /* BINARY_MOTION_PROTOCOL */
+
+/******************************************************************************
+      END FILE
+******************************************************************************/
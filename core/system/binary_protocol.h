@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    binary_protocol.h
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Framed binary motion protocol, received alongside text g-code.
+  ******************************************************************************
+**/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GRBL_BINARY_PROTOCOL_H
+#define __GRBL_BINARY_PROTOCOL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "nuts_bolts.h"
+
+/* Exported define -----------------------------------------------------------*/
+/* Frame layout, all multi-byte values little endian:
+     [STX][LEN][TYPE][PAYLOAD, LEN bytes][CRC low][CRC high]
+   The CRC is a CRC-16/CCITT (poly 0x1021, init 0xFFFF) over LEN, TYPE and PAYLOAD.
+   STX is a control character, never part of a text g-code line. The serial RX path passes whole
+   frames to the RX buffer unfiltered, so payload bytes are never taken as realtime commands.
+   A frame with a LEN above BIN_FRAME_MAX_PAYLOAD or a bad CRC is answered by its error, then the
+   bytes up to the next STX or line end are dropped, so a lost byte does not shift later frames. */
+#define BIN_FRAME_START               0x02
+#define BIN_FRAME_MAX_PAYLOAD         64
+/* number of bytes following the LEN byte: TYPE, PAYLOAD and CRC */
+#define BIN_FRAME_TAIL_LENGTH(len)    ((uint16_t)(len) + 3)
+
+/* Frame types */
+#define BIN_FRAME_TYPE_LINE_MM        0x01 // Line motion, machine coordinate target in mm as float
+#define BIN_FRAME_TYPE_LINE_STEPS     0x02 // Line motion, machine coordinate target in steps as int32
+#define BIN_FRAME_TYPE_VALIDATE_BEGIN 0x03 // Start a validation, no payload. PROGRAM_VALIDATION only
+#define BIN_FRAME_TYPE_VALIDATE_END   0x04 // End the validation and report its summary, no payload
+
+/* Between VALIDATE_BEGIN and VALIDATE_END, line motion frames are validated in check mode instead
+   of executed. Each is counted as a line of the job and answered by ok, its errors go to the
+   summary reported upon VALIDATE_END. See validation.h */
+
+/* Line motion payload, offsets in bytes:
+     0  uint8    condition, PL_COND_FLAG_RAPID_MOTION, _NO_FEED_OVERRIDE and _INVERSE_TIME only
+     1  int32    line number, reported with N: if USE_LINE_NUMBERS
+     5  float    feed rate, mm/min or inverse time
+     9  float    spindle speed for the block
+     13 target   N_AXIS float or int32 values */
+#define BIN_LINE_PAYLOAD_LENGTH       (13 + 4*N_AXIS)
+
+/* binary_protocol_process_byte() results */
+#define BIN_FRAME_NONE                0 // Byte is not part of a frame, handle as text
+#define BIN_FRAME_PENDING             1 // Byte consumed, frame incomplete
+#define BIN_FRAME_COMPLETE            2 // Byte consumed, frame ready for binary_protocol_execute_frame()
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported typedef ----------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+/* Exported function ---------------------------------------------------------*/
+extern void binary_protocol_reset(void);
+extern uint8_t binary_protocol_process_byte(uint8_t c);
+extern uint8_t binary_protocol_frame_pending(void);
+extern uint8_t binary_protocol_execute_frame(void);
+
+
+#endif /* __GRBL_BINARY_PROTOCOL_H */
+/******************************************************************************
+      END FILE
+******************************************************************************/
@@ -0,0 +1,394 @@
+/**
+  ******************************************************************************
+  * @file    expression.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Numbered parameters and bracketed expressions of parametric g-code. A value is parsed
+             once into postfix stack code, which is cheap to evaluate again, as for the blocks of
+             a loop.
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <math.h>
+#include "expression.h"
+#include "report.h"
+
+#ifdef PARAMETRIC_GCODE
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    char *line;
+    uint8_t char_counter;
+    uint8_t *code;
+    uint8_t max_length;
+    uint8_t length;
+    uint8_t depth;            // Values on the stack at this point of the code
+    uint8_t nesting;          // Values being compiled within each other at this point of the line
+} expr_compiler_t;
+
+typedef struct {
+    char name[6];
+    uint8_t op;
+} expr_name_t;
+
+/* Private define ------------------------------------------------------------*/
+/* Opcodes, a constant is followed by its float value, a parameter by its index */
+#define EXPR_OP_CONST         0
+#define EXPR_OP_PARAM         1
+#define EXPR_OP_PARAM_VALUE   2   // Parameter of the number on the stack
+/* Binary operations */
+#define EXPR_OP_POW           3
+#define EXPR_OP_MUL           4
+#define EXPR_OP_DIV           5
+#define EXPR_OP_MOD           6
+#define EXPR_OP_ADD           7
+#define EXPR_OP_SUB           8
+#define EXPR_OP_EQ            9
+#define EXPR_OP_NE            10
+#define EXPR_OP_GT            11
+#define EXPR_OP_GE            12
+#define EXPR_OP_LT            13
+#define EXPR_OP_LE            14
+#define EXPR_OP_AND           15
+#define EXPR_OP_OR            16
+#define EXPR_OP_XOR           17
+#define EXPR_OP_ATAN2         18
+/* Unary operations */
+#define EXPR_OP_NEG           19
+#define EXPR_OP_ABS           20
+#define EXPR_OP_ACOS          21
+#define EXPR_OP_ASIN          22
+#define EXPR_OP_ATAN          23  // Only compiled as EXPR_OP_ATAN2, ATAN[y]/[x]
+#define EXPR_OP_COS           24
+#define EXPR_OP_EXP           25
+#define EXPR_OP_FIX           26
+#define EXPR_OP_FUP           27
+#define EXPR_OP_LN            28
+#define EXPR_OP_ROUND         29
+#define EXPR_OP_SIN           30
+#define EXPR_OP_SQRT          31
+#define EXPR_OP_TAN           32
+/* Angle conversions, single precision */
+#define EXPR_DEG_PER_RAD      57.29577951f
+#define EXPR_RAD_PER_DEG      0.01745329252f
+
+/* Private macro -------------------------------------------------------------*/
+#define EXPR_IS_BINARY(op)    (((op) >= EXPR_OP_POW) && ((op) <= EXPR_OP_ATAN2))
+#define EXPR_IS_LETTER(c)     (((c) >= 'A') && ((c) <= 'Z'))
+
+/* Private variables ---------------------------------------------------------*/
+float expr_parameters[EXPR_PARAMETERS];
+
+/* Binary operators, with their precedence */
+static const expr_name_t expr_operators[] = {
+    {"**", EXPR_OP_POW}, {"*", EXPR_OP_MUL}, {"/", EXPR_OP_DIV}, {"MOD", EXPR_OP_MOD},
+    {"+", EXPR_OP_ADD}, {"-", EXPR_OP_SUB},
+    {"EQ", EXPR_OP_EQ}, {"NE", EXPR_OP_NE}, {"GT", EXPR_OP_GT}, {"GE", EXPR_OP_GE},
+    {"LT", EXPR_OP_LT}, {"LE", EXPR_OP_LE},
+    {"AND", EXPR_OP_AND}, {"OR", EXPR_OP_OR}, {"XOR", EXPR_OP_XOR}
+};
+static const uint8_t expr_precedence[] = {
+    4, 3, 3, 3,
+    2, 2,
+    1, 1, 1, 1,
+    1, 1,
+    0, 0, 0
+};
+static const expr_name_t expr_functions[] = {
+    {"ABS", EXPR_OP_ABS}, {"ACOS", EXPR_OP_ACOS}, {"ASIN", EXPR_OP_ASIN}, {"ATAN", EXPR_OP_ATAN},
+    {"COS", EXPR_OP_COS}, {"EXP", EXPR_OP_EXP}, {"FIX", EXPR_OP_FIX}, {"FUP", EXPR_OP_FUP},
+    {"LN", EXPR_OP_LN}, {"ROUND", EXPR_OP_ROUND}, {"SIN", EXPR_OP_SIN}, {"SQRT", EXPR_OP_SQRT},
+    {"TAN", EXPR_OP_TAN}
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t _compile_value(expr_compiler_t *c);
+static uint8_t _compile_expression(expr_compiler_t *c, uint8_t min_precedence);
+
+/* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Appends an opcode and its operand, and tracks the stack depth.
+  * @param  expr_compiler_t *c, uint8_t op, const void *operand, uint8_t operand_length
+  * @retval uint8_t STATUS_OK or STATUS_EXPRESSION_INVALID if too long or too deep
+  */
+static uint8_t _emit(expr_compiler_t *c, uint8_t op, const void *operand, uint8_t operand_length) {
+    if ((c->max_length - c->length) < (1 + operand_length)) { return(STATUS_EXPRESSION_INVALID); }
+    c->code[c->length++] = op;
+    if (operand_length) { memcpy(&c->code[c->length], operand, operand_length); }
+    c->length += operand_length;
+    /* */
+    if (op <= EXPR_OP_PARAM) {
+        if (++c->depth > EXPR_STACK_DEPTH) { return(STATUS_EXPRESSION_INVALID); }
+    } else if (EXPR_IS_BINARY(op)) {
+        c->depth--;
+    }
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Matches a name of a table at the line position, the longest first.
+  * @param  expr_compiler_t *c, const expr_name_t *names, uint8_t count
+  * @retval uint8_t table index, count if none
+  */
+static uint8_t _match_name(expr_compiler_t *c, const expr_name_t *names, uint8_t count) {
+    uint8_t match = count;
+    uint8_t match_length = 0;
+    /* */
+    for (uint8_t idx = 0; idx < count; idx++) {
+        uint8_t length = strlen(names[idx].name);
+        if ((length > match_length) && (strncmp(&c->line[c->char_counter], names[idx].name, length) == 0)) {
+            match = idx;
+            match_length = length;
+        }
+    }
+    if (match != count) { c->char_counter += match_length; }
+    return(match);
+}
+
+/**
+  * @brief  Compiles a bracketed expression, the line at its '['.
+  * @param  expr_compiler_t *c
+  * @retval uint8_t status code
+  */
+static uint8_t _compile_brackets(expr_compiler_t *c) {
+    if (c->line[c->char_counter++] != '[') { return(STATUS_EXPRESSION_INVALID); }
+    uint8_t status = _compile_expression(c, 0);
+    if (status != STATUS_OK) { return(status); }
+    if (c->line[c->char_counter++] != ']') { return(STATUS_EXPRESSION_INVALID); }
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Compiles one value: number, parameter, bracketed expression, function or negation.
+  * @param  expr_compiler_t *c
+  * @retval uint8_t status code
+  */
+static uint8_t _compile_operand(expr_compiler_t *c) {
+    char *line = c->line;
+    uint8_t status;
+    float value;
+    /* */
+    switch (line[c->char_counter]) {
+        case '[':
+            return(_compile_brackets(c));
+        /* */
+        case '#':
+            c->char_counter++;
+            if ((line[c->char_counter] >= '0') && (line[c->char_counter] <= '9')) {
+                // Parameter of a literal number, resolved now.
+                uint8_t index;
+                if (!read_float(line, &c->char_counter, &value)) { return(STATUS_EXPRESSION_INVALID); }
+                status = expr_parameter_index(value, &index);
+                if (status != STATUS_OK) { return(status); }
+                return(_emit(c, EXPR_OP_PARAM, &index, sizeof(uint8_t)));
+            }
+            status = _compile_value(c);
+            if (status != STATUS_OK) { return(status); }
+            return(_emit(c, EXPR_OP_PARAM_VALUE, NULL, 0));
+        /* */
+        case '-':
+        case '+':
+            if (expr_is_value(line, c->char_counter + 1) && (line[c->char_counter + 1] != '-') && (line[c->char_counter + 1] != '+')) {
+                uint8_t negate = (line[c->char_counter++] == '-');
+                status = _compile_value(c);
+                if ((status != STATUS_OK) || !negate) { return(status); }
+                return(_emit(c, EXPR_OP_NEG, NULL, 0));
+            }
+            break;
+        /* */
+        default:
+            if (EXPR_IS_LETTER(line[c->char_counter])) {
+                uint8_t idx = _match_name(c, expr_functions, sizeof(expr_functions)/sizeof(expr_name_t));
+                if (idx == sizeof(expr_functions)/sizeof(expr_name_t)) { return(STATUS_BAD_NUMBER_FORMAT); }
+                status = _compile_brackets(c);
+                if (status != STATUS_OK) { return(status); }
+                if (expr_functions[idx].op != EXPR_OP_ATAN) { return(_emit(c, expr_functions[idx].op, NULL, 0)); }
+                // ATAN[y]/[x]
+                if (line[c->char_counter++] != '/') { return(STATUS_EXPRESSION_INVALID); }
+                status = _compile_brackets(c);
+                if (status != STATUS_OK) { return(status); }
+                return(_emit(c, EXPR_OP_ATAN2, NULL, 0));
+            }
+        break;
+    }
+    if (!read_float(line, &c->char_counter, &value)) { return(STATUS_BAD_NUMBER_FORMAT); }
+    return(_emit(c, EXPR_OP_CONST, &value, sizeof(float)));
+}
+
+/**
+  * @brief  Compiles one value, within at most EXPR_NESTING_DEPTH values being compiled. Bounds the
+            recursion of nested brackets, parameters and negations by more than the line length.
+  * @param  expr_compiler_t *c
+  * @retval uint8_t status code
+  */
+static uint8_t _compile_value(expr_compiler_t *c) {
+    if (c->nesting == EXPR_NESTING_DEPTH) { return(STATUS_EXPRESSION_INVALID); }
+    c->nesting++;
+    uint8_t status = _compile_operand(c);
+    c->nesting--;
+    return(status);
+}
+
+/**
+  * @brief  Compiles the operations of an expression by precedence climbing, down to the given
+            precedence, left to right.
+  * @param  expr_compiler_t *c, uint8_t min_precedence
+  * @retval uint8_t status code
+  */
+static uint8_t _compile_expression(expr_compiler_t *c, uint8_t min_precedence) {
+    uint8_t status = _compile_value(c);
+    /* */
+    while (status == STATUS_OK) {
+        uint8_t char_counter = c->char_counter;
+        uint8_t idx = _match_name(c, expr_operators, sizeof(expr_operators)/sizeof(expr_name_t));
+        if ((idx == sizeof(expr_operators)/sizeof(expr_name_t)) || (expr_precedence[idx] < min_precedence)) {
+            c->char_counter = char_counter;
+            break;
+        }
+        status = _compile_expression(c, expr_precedence[idx] + 1);
+        if (status == STATUS_OK) { status = _emit(c, expr_operators[idx].op, NULL, 0); }
+    }
+    return(status);
+}
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  Tells if the value at the line position is more than a number, to be compiled.
+  * @param  char *line, uint8_t char_counter
+  * @retval true for a parameter, expression or function, possibly negated
+  */
+uint8_t expr_is_value(char *line, uint8_t char_counter) {
+    char c = line[char_counter];
+    if ((c == '-') || (c == '+')) { c = line[char_counter + 1]; }
+    return((c == '#') || (c == '[') || EXPR_IS_LETTER(c));
+}
+
+/**
+  * @brief  Compiles the value at the line position into stack code.
+  * @param  char *line, uint8_t *char_counter, moved past the value, uint8_t *code,
+            uint8_t max_length, uint8_t *length, bytes of code
+  * @retval uint8_t status code
+  */
+uint8_t expr_compile(char *line, uint8_t *char_counter, uint8_t *code, uint8_t max_length, uint8_t *length) {
+    expr_compiler_t c = { line, *char_counter, code, max_length, 0, 0, 0 };
+    /* */
+    uint8_t status = _compile_value(&c);
+    *char_counter = c.char_counter;
+    *length = c.length;
+    return(status);
+}
+
+/**
+  * @brief  Evaluates compiled stack code.
+  * @param  const uint8_t *code, uint8_t length, float *value
+  * @retval uint8_t STATUS_OK, STATUS_EXPRESSION_PARAMETER for a computed parameter out of range or
+            STATUS_EXPRESSION_MATH for a division by zero or a value out of a function domain
+  */
+uint8_t expr_evaluate(const uint8_t *code, uint8_t length, float *value) {
+    float stack[EXPR_STACK_DEPTH];
+    uint8_t top = 0;          // Values on the stack, the topmost at stack[top - 1]
+    uint8_t pos = 0;
+    uint8_t index;
+    /* */
+    while (pos < length) {
+        uint8_t op = code[pos++];
+        float a = 0.0f;
+        float b = 0.0f;
+        if (EXPR_IS_BINARY(op)) { b = stack[--top]; }
+        if (op > EXPR_OP_PARAM) { a = stack[--top]; }
+        switch (op) {
+            case EXPR_OP_CONST: memcpy(&a, &code[pos], sizeof(float)); pos += sizeof(float); break;
+            case EXPR_OP_PARAM: a = expr_parameters[code[pos++]]; break;
+            case EXPR_OP_PARAM_VALUE:
+                if (expr_parameter_index(a, &index) != STATUS_OK) { return(STATUS_EXPRESSION_PARAMETER); }
+                a = expr_parameters[index];
+            break;
+            /* */
+            case EXPR_OP_POW: a = powf(a, b); break;
+            case EXPR_OP_MUL: a *= b; break;
+            case EXPR_OP_DIV:
+                if (b == 0.0f) { return(STATUS_EXPRESSION_MATH); }
+                a /= b;
+            break;
+            case EXPR_OP_MOD:
+                if (b == 0.0f) { return(STATUS_EXPRESSION_MATH); }
+                a = fmodf(a, b);
+            break;
+            case EXPR_OP_ADD: a += b; break;
+            case EXPR_OP_SUB: a -= b; break;
+            case EXPR_OP_EQ: a = (a == b); break;
+            case EXPR_OP_NE: a = (a != b); break;
+            case EXPR_OP_GT: a = (a > b); break;
+            case EXPR_OP_GE: a = (a >= b); break;
+            case EXPR_OP_LT: a = (a < b); break;
+            case EXPR_OP_LE: a = (a <= b); break;
+            case EXPR_OP_AND: a = ((a != 0.0f) && (b != 0.0f)); break;
+            case EXPR_OP_OR: a = ((a != 0.0f) || (b != 0.0f)); break;
+            case EXPR_OP_XOR: a = ((a != 0.0f) != (b != 0.0f)); break;
+            case EXPR_OP_ATAN2: a = atan2f(a, b)*EXPR_DEG_PER_RAD; break;
+            /* */
+            case EXPR_OP_NEG: a = -a; break;
+            case EXPR_OP_ABS: a = fabsf(a); break;
+            case EXPR_OP_ACOS:
+            case EXPR_OP_ASIN:
+                if ((a < -1.0f) || (a > 1.0f)) { return(STATUS_EXPRESSION_MATH); }
+                a = ((op == EXPR_OP_ACOS) ? acosf(a) : asinf(a))*EXPR_DEG_PER_RAD;
+            break;
+            case EXPR_OP_COS: a = cosf(a*EXPR_RAD_PER_DEG); break;
+            case EXPR_OP_EXP: a = expf(a); break;
+            case EXPR_OP_FIX: a = floorf(a); break;
+            case EXPR_OP_FUP: a = ceilf(a); break;
+            case EXPR_OP_LN:
+                if (a <= 0.0f) { return(STATUS_EXPRESSION_MATH); }
+                a = logf(a);
+            break;
+            case EXPR_OP_ROUND: a = roundf(a); break;
+            case EXPR_OP_SIN: a = sinf(a*EXPR_RAD_PER_DEG); break;
+            case EXPR_OP_SQRT:
+                if (a < 0.0f) { return(STATUS_EXPRESSION_MATH); }
+                a = sqrtf(a);
+            break;
+            case EXPR_OP_TAN: a = tanf(a*EXPR_RAD_PER_DEG); break;
+            default: return(STATUS_EXPRESSION_INVALID);
+        }
+        stack[top++] = a;
+    }
+    *value = stack[0];
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Tells if compiled code is a plain constant, which may be stored as its value.
+  * @param  const uint8_t *code, uint8_t length, float *value
+  * @retval true for a constant
+  */
+uint8_t expr_constant(const uint8_t *code, uint8_t length, float *value) {
+    if ((length != (1 + sizeof(float))) || (code[0] != EXPR_OP_CONST)) { return(false); }
+    memcpy(value, &code[1], sizeof(float));
+    return(true);
+}
+
+/**
+  * @brief  Checks a parameter number.
+  * @param  float number, uint8_t *index
+  * @retval uint8_t STATUS_OK or STATUS_EXPRESSION_PARAMETER if not an integer of the range
+  */
+uint8_t expr_parameter_index(float number, uint8_t *index) {
+    if ((number < 0.0f) || (number > (EXPR_PARAMETERS - 1)) || (number != truncf(number))) {
+        return(STATUS_EXPRESSION_PARAMETER);
+    }
+    *index = (uint8_t)number;
+    return(STATUS_OK);
+}
+
+#endif  /* PARAMETRIC_GCODE */
+
+/******************************************************************************
+      END FILE
+******************************************************************************/
@@ -0,0 +1,54 @@
+/**
+  ******************************************************************************
+  * @file    expression.h
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Numbered parameters and bracketed expressions of parametric g-code, compiled into a
+             stack bytecode and evaluated from it.
+  ******************************************************************************
+**/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GRBL_EXPRESSION_H
+#define __GRBL_EXPRESSION_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "nuts_bolts.h"
+
+/* Exported define -----------------------------------------------------------*/
+/* Values, where g-code accepts a number:
+     #n                 parameter n, an integer from 0 to EXPR_PARAMETERS-1, #0 is always 0
+     #<value>           parameter of a computed number, as #[#1+1] or ##1
+     [expression]       binary operations on values, from highest to lowest precedence:
+                        **, * / MOD, + -, EQ NE GT GE LT LE, AND OR XOR, left to right
+     FUNC[expression]   ABS ACOS ASIN COS EXP FIX FUP LN ROUND SIN SQRT TAN, ATAN[y]/[x]
+     -value             negation
+   Angles are in degrees. Comparisons and logical operations give 1 for true and 0 for false.
+   Parameters are set by #n=value, after all values of the line are read. */
+#ifndef EXPR_PARAMETERS
+  #define EXPR_PARAMETERS     100   // (1-256) Numbered parameters, #0 to #99
+#endif
+#define EXPR_STACK_DEPTH      16    // Values pending within an expression
+#define EXPR_NESTING_DEPTH    16    // Brackets, parameters and negations nested within a value
+#define EXPR_CODE_SIZE        64    // Bytes of the code of one value compiled from a line
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported typedef ----------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+extern float expr_parameters[EXPR_PARAMETERS];
+
+/* Exported function ---------------------------------------------------------*/
+extern uint8_t expr_is_value(char *line, uint8_t char_counter);
+extern uint8_t expr_compile(char *line, uint8_t *char_counter, uint8_t *code, uint8_t max_length, uint8_t *length);
+extern uint8_t expr_evaluate(const uint8_t *code, uint8_t length, float *value);
+extern uint8_t expr_constant(const uint8_t *code, uint8_t length, float *value);
+extern uint8_t expr_parameter_index(float number, uint8_t *index);
+
+
+#endif /* __GRBL_EXPRESSION_H */
+/******************************************************************************
+      END FILE
+******************************************************************************/
@@ -20,9 +20,37 @@
 #include "coolant_control.h"
 #include "motion_control.h"
 #include "protocol.h"
+#ifdef PARAMETRIC_GCODE
+  #include "expression.h"
+#endif
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
 
 
 /* Private typedef -----------------------------------------------------------*/
+/* 'G' and 'M' command word dispatch entry */
+typedef struct {
+  uint8_t group;    // Modal group, MODAL_GROUP_xx
+  uint8_t value;    // Modal state or non-modal action set by the command
+  uint8_t flags;    // GC_CMD_xx and the AXIS_COMMAND_xx the command implies
+} gc_command_t;
+
+/* Fractional 'G' command word dispatch entry, Gxx.x */
+typedef struct {
+  uint8_t int_value;
+  uint8_t mantissa;
+  gc_command_t command;
+} gc_fractional_command_t;
+
+#ifdef PARAMETRIC_GCODE
+/* Parameter setting of a block, #n=value, applied once the block is checked */
+typedef struct {
+  uint8_t index;
+  float value;
+} gc_parameter_setting_t;
+#endif
+
 /* Private define ------------------------------------------------------------*/
 /* NOTE: Max line number is defined by the g-code standard to be 99999. It seems to be an
    arbitrary value, and some GUIs may require more. So we increased it based on a max safe
@@ -35,16 +63,520 @@
 #define AXIS_COMMAND_MOTION_MODE 2
 #define AXIS_COMMAND_TOOL_LENGTH_OFFSET 3 // *Undefined but required
 
+/* gc_command_t flags, the low bits hold the implied axis command */
+#define GC_CMD_AXIS_MASK    0x03
+#define GC_CMD_VALID        bit(2)  // Supported command
+#define GC_CMD_NO_ACTION    bit(3)  // Valid, but sets no state
+#define GC_CMD_MERGE        bit(4)  // Value is or-ed into the state (M7, M8)
+#define GC_CMD_FRACTIONAL   bit(5)  // Gxx.x variants exist, others are unsupported rather than non-integer
+
+#define GC_G_COMMANDS       100     // G0 to G99
+#define GC_M_COMMANDS       57      // M0 to M56
+
+#define GC_WORD_UNSUPPORTED 0xFF
+
 /* Private macro -------------------------------------------------------------*/
 #define FAIL(status) return(status);
+#define GC_MOTION_IS_CANNED(motion)   (((motion) == MOTION_MODE_DRILL_CHIP_BREAK) || \
+                                       (((motion) >= MOTION_MODE_DRILL) && ((motion) <= MOTION_MODE_DRILL_PECK)))
+#define GC_CMD(group, value, flags)   { (group), (value), (flags)|GC_CMD_VALID }
 
 /* Private variables ---------------------------------------------------------*/
 /* gc extern struct */
 parser_state_t gc_state;
 parser_block_t gc_block;
 
+/* 'G' command words, indexed by the integer value */
+static const gc_command_t gc_g_commands[GC_G_COMMANDS] = {
+  [0]  = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_SEEK, AXIS_COMMAND_MOTION_MODE),
+  [1]  = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_LINEAR, AXIS_COMMAND_MOTION_MODE),
+  [2]  = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_CW_ARC, AXIS_COMMAND_MOTION_MODE),
+  [3]  = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_CCW_ARC, AXIS_COMMAND_MOTION_MODE),
+  [4]  = GC_CMD(MODAL_GROUP_G0, NON_MODAL_DWELL, 0),
+  [10] = GC_CMD(MODAL_GROUP_G0, NON_MODAL_SET_COORDINATE_DATA, AXIS_COMMAND_NON_MODAL),
+  [17] = GC_CMD(MODAL_GROUP_G2, PLANE_SELECT_XY, 0),
+  [18] = GC_CMD(MODAL_GROUP_G2, PLANE_SELECT_ZX, 0),
+  [19] = GC_CMD(MODAL_GROUP_G2, PLANE_SELECT_YZ, 0),
+  [20] = GC_CMD(MODAL_GROUP_G6, UNITS_MODE_INCHES, 0),
+  [21] = GC_CMD(MODAL_GROUP_G6, UNITS_MODE_MM, 0),
+  [28] = GC_CMD(MODAL_GROUP_G0, NON_MODAL_GO_HOME_0, AXIS_COMMAND_NON_MODAL|GC_CMD_FRACTIONAL),
+  [30] = GC_CMD(MODAL_GROUP_G0, NON_MODAL_GO_HOME_1, AXIS_COMMAND_NON_MODAL|GC_CMD_FRACTIONAL),
+  [38] = { MODAL_GROUP_G1, 0, GC_CMD_FRACTIONAL }, // G38.x only
+  // NOTE: Cutter radius compensation is always disabled. Only here to support G40 commands that
+  // often appear in g-code program headers to setup defaults.
+  [40] = GC_CMD(MODAL_GROUP_G7, CUTTER_COMP_DISABLE, GC_CMD_NO_ACTION),
+  // NOTE: The NIST g-code standard vaguely states that when a tool length offset is changed,
+  // there cannot be any axis motion or coordinate offsets updated. Meaning G43, G43.1, and G49
+  // all are explicit axis commands, regardless if they require axis words or not.
+  [43] = { MODAL_GROUP_G8, 0, GC_CMD_FRACTIONAL }, // G43.1 only
+  [49] = GC_CMD(MODAL_GROUP_G8, TOOL_LENGTH_OFFSET_CANCEL, AXIS_COMMAND_TOOL_LENGTH_OFFSET),
+  // NOTE: G51 and G68 take the axis words as their center, like the non-modal axis commands.
+  [50] = GC_CMD(MODAL_GROUP_G11, SCALING_DISABLE, 0),
+  [51] = GC_CMD(MODAL_GROUP_G11, SCALING_ENABLE, AXIS_COMMAND_NON_MODAL),
+  [53] = GC_CMD(MODAL_GROUP_G0, NON_MODAL_ABSOLUTE_OVERRIDE, 0),
+  // NOTE: G59.x are not supported. (But their int_values would be 60, 61, and 62.)
+  [54] = GC_CMD(MODAL_GROUP_G12, 0, 0), // Shifted to array indexing.
+  [55] = GC_CMD(MODAL_GROUP_G12, 1, 0),
+  [56] = GC_CMD(MODAL_GROUP_G12, 2, 0),
+  [57] = GC_CMD(MODAL_GROUP_G12, 3, 0),
+  [58] = GC_CMD(MODAL_GROUP_G12, 4, 0),
+  [59] = GC_CMD(MODAL_GROUP_G12, 5, 0),
+  [61] = GC_CMD(MODAL_GROUP_G13, CONTROL_MODE_EXACT_PATH, GC_CMD_NO_ACTION|GC_CMD_FRACTIONAL),
+  [68] = GC_CMD(MODAL_GROUP_G16, ROTATION_ENABLE, AXIS_COMMAND_NON_MODAL),
+  [69] = GC_CMD(MODAL_GROUP_G16, ROTATION_DISABLE, 0),
+  [73] = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_DRILL_CHIP_BREAK, AXIS_COMMAND_MOTION_MODE),
+  [80] = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_NONE, 0),
+  [81] = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_DRILL, AXIS_COMMAND_MOTION_MODE),
+  [82] = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_DRILL_DWELL, AXIS_COMMAND_MOTION_MODE),
+  [83] = GC_CMD(MODAL_GROUP_G1, MOTION_MODE_DRILL_PECK, AXIS_COMMAND_MOTION_MODE),
+  [90] = GC_CMD(MODAL_GROUP_G3, DISTANCE_MODE_ABSOLUTE, GC_CMD_FRACTIONAL),
+  [91] = GC_CMD(MODAL_GROUP_G3, DISTANCE_MODE_INCREMENTAL, GC_CMD_FRACTIONAL),
+  [92] = GC_CMD(MODAL_GROUP_G0, NON_MODAL_SET_COORDINATE_OFFSET, AXIS_COMMAND_NON_MODAL|GC_CMD_FRACTIONAL),
+  [93] = GC_CMD(MODAL_GROUP_G5, FEED_RATE_MODE_INVERSE_TIME, 0),
+  [94] = GC_CMD(MODAL_GROUP_G5, FEED_RATE_MODE_UNITS_PER_MIN, 0),
+  [98] = GC_CMD(MODAL_GROUP_G10, RETRACT_MODE_OLD_Z, 0),
+  [99] = GC_CMD(MODAL_GROUP_G10, RETRACT_MODE_R, 0),
+};
+
+/* Supported Gxx.x command words, mantissa multiplied by 100 */
+static const gc_fractional_command_t gc_g_fractional_commands[] = {
+  { 28, 10, GC_CMD(MODAL_GROUP_G0, NON_MODAL_SET_HOME_0, 0) },
+  { 30, 10, GC_CMD(MODAL_GROUP_G0, NON_MODAL_SET_HOME_1, 0) },
+  { 38, 20, GC_CMD(MODAL_GROUP_G1, MOTION_MODE_PROBE_TOWARD, AXIS_COMMAND_MOTION_MODE) },
+  { 38, 30, GC_CMD(MODAL_GROUP_G1, MOTION_MODE_PROBE_TOWARD_NO_ERROR, AXIS_COMMAND_MOTION_MODE) },
+  { 38, 40, GC_CMD(MODAL_GROUP_G1, MOTION_MODE_PROBE_AWAY, AXIS_COMMAND_MOTION_MODE) },
+  { 38, 50, GC_CMD(MODAL_GROUP_G1, MOTION_MODE_PROBE_AWAY_NO_ERROR, AXIS_COMMAND_MOTION_MODE) },
+  { 43, 10, GC_CMD(MODAL_GROUP_G8, TOOL_LENGTH_OFFSET_ENABLE_DYNAMIC, AXIS_COMMAND_TOOL_LENGTH_OFFSET) },
+  // Arc IJK incremental mode is default. G91.1 does nothing.
+  { 91, 10, GC_CMD(MODAL_GROUP_G4, DISTANCE_ARC_MODE_INCREMENTAL, GC_CMD_NO_ACTION) },
+  { 92, 10, GC_CMD(MODAL_GROUP_G0, NON_MODAL_RESET_COORDINATE_OFFSET, 0) },
+};
+
+/* 'M' command words, indexed by the integer value */
+static const gc_command_t gc_m_commands[GC_M_COMMANDS] = {
+  [0]  = GC_CMD(MODAL_GROUP_M4, PROGRAM_FLOW_PAUSED, 0), // Program pause
+  [1]  = GC_CMD(MODAL_GROUP_M4, PROGRAM_FLOW_OPTIONAL_STOP, GC_CMD_NO_ACTION), // Optional stop not supported. Ignore.
+  [2]  = GC_CMD(MODAL_GROUP_M4, PROGRAM_FLOW_COMPLETED_M2, 0), // Program end and reset
+  [3]  = GC_CMD(MODAL_GROUP_M7, SPINDLE_ENABLE_CW, 0),
+  [4]  = GC_CMD(MODAL_GROUP_M7, SPINDLE_ENABLE_CCW, 0),
+  [5]  = GC_CMD(MODAL_GROUP_M7, SPINDLE_DISABLE, 0),
+  #ifdef ENABLE_M7
+    [7]  = GC_CMD(MODAL_GROUP_M8, COOLANT_MIST_ENABLE, GC_CMD_MERGE),
+  #endif
+  [8]  = GC_CMD(MODAL_GROUP_M8, COOLANT_FLOOD_ENABLE, GC_CMD_MERGE),
+  [9]  = GC_CMD(MODAL_GROUP_M8, COOLANT_DISABLE, 0), // M9 disables both M7 and M8.
+  [30] = GC_CMD(MODAL_GROUP_M4, PROGRAM_FLOW_COMPLETED_M30, 0), // Program end and reset
+  #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
+    [56] = GC_CMD(MODAL_GROUP_M9, OVERRIDE_PARKING_MOTION, 0),
+  #endif
+};
+
+/* Block state set by each modal group, NULL for groups without tracked state */
+static uint8_t * const gc_command_state[] = {
+  [MODAL_GROUP_G0]  = &gc_block.non_modal_command,
+  [MODAL_GROUP_G1]  = &gc_block.modal.motion,
+  [MODAL_GROUP_G2]  = &gc_block.modal.plane_select,
+  [MODAL_GROUP_G3]  = &gc_block.modal.distance,
+  [MODAL_GROUP_G4]  = NULL, // distance_arc, only default supported
+  [MODAL_GROUP_G5]  = &gc_block.modal.feed_rate,
+  [MODAL_GROUP_G6]  = &gc_block.modal.units,
+  [MODAL_GROUP_G7]  = NULL, // cutter_comp, only default supported
+  [MODAL_GROUP_G8]  = &gc_block.modal.tool_length,
+  [MODAL_GROUP_G12] = &gc_block.modal.coord_select,
+  [MODAL_GROUP_G13] = NULL, // control, only default supported
+  [MODAL_GROUP_G10] = &gc_block.modal.retract,
+  [MODAL_GROUP_M4]  = &gc_block.modal.program_flow,
+  [MODAL_GROUP_M7]  = &gc_block.modal.spindle,
+  [MODAL_GROUP_M8]  = &gc_block.modal.coolant,
+  [MODAL_GROUP_M9]  = &gc_block.modal.override,
+  [MODAL_GROUP_G11] = &gc_block.modal.scaling,
+  [MODAL_GROUP_G16] = &gc_block.modal.rotation,
+};
+
+/* Value word of each letter, indexed by letter - 'A' */
+static const uint8_t gc_value_words[26] = {
+  GC_WORD_UNSUPPORTED,  // A
+  GC_WORD_UNSUPPORTED,  // B
+  GC_WORD_UNSUPPORTED,  // C
+  GC_WORD_UNSUPPORTED,  // D
+  GC_WORD_UNSUPPORTED,  // E
+  WORD_F,               // F
+  GC_WORD_UNSUPPORTED,  // G, command word
+  GC_WORD_UNSUPPORTED,  // H
+  WORD_I,               // I
+  WORD_J,               // J
+  WORD_K,               // K
+  WORD_L,               // L
+  GC_WORD_UNSUPPORTED,  // M, command word
+  WORD_N,               // N
+  GC_WORD_UNSUPPORTED,  // O
+  WORD_P,               // P, for certain commands P value must be an integer, but none of these commands are supported.
+  WORD_Q,               // Q
+  WORD_R,               // R
+  WORD_S,               // S
+  WORD_T,               // T
+  GC_WORD_UNSUPPORTED,  // U
+  GC_WORD_UNSUPPORTED,  // V
+  GC_WORD_UNSUPPORTED,  // W
+  WORD_X,               // X
+  WORD_Y,               // Y
+  WORD_Z,               // Z
+};
+
+/* Float value of each value word, NULL for the integer words L, N and T */
+static float * const gc_word_values[] = {
+  [WORD_F] = &gc_block.values.f,
+  [WORD_I] = &gc_block.values.ijk[X_AXIS],
+  [WORD_J] = &gc_block.values.ijk[Y_AXIS],
+  [WORD_K] = &gc_block.values.ijk[Z_AXIS],
+  [WORD_L] = NULL,
+  [WORD_N] = NULL,
+  [WORD_P] = &gc_block.values.p,
+  [WORD_Q] = &gc_block.values.q,
+  [WORD_R] = &gc_block.values.r,
+  [WORD_S] = &gc_block.values.s,
+  [WORD_T] = NULL,
+  [WORD_X] = &gc_block.values.xyz[X_AXIS],
+  [WORD_Y] = &gc_block.values.xyz[Y_AXIS],
+  [WORD_Z] = &gc_block.values.xyz[Z_AXIS],
+};
+
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Looks up a 'G' or 'M' command word in the dispatch tables.
+  * @param  char letter, uint8_t int_value, uint16_t mantissa, x100,
+            const gc_command_t **command, set to the table entry
+  * @retval uint8_t STATUS_OK, STATUS_GCODE_UNSUPPORTED_COMMAND or STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER
+  */
+static uint8_t gc_lookup_command(char letter, uint8_t int_value, uint16_t mantissa, const gc_command_t **command) {
+  const gc_command_t *entry;
+  /* */
+  if (letter == 'M') {
+    if (mantissa > 0) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [No Mxx.x commands]
+    if (int_value >= GC_M_COMMANDS) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported M command]
+    entry = &gc_m_commands[int_value];
+    if (!(entry->flags & GC_CMD_VALID)) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported M command]
+    *command = entry;
+    return(STATUS_OK);
+  }
+  /* */
+  if (int_value >= GC_G_COMMANDS) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported G command]
+  entry = &gc_g_commands[int_value];
+  if (mantissa > 0) {
+    // Gxx.x command. Other fractions of a supported command are non-integer values, except for
+    // commands with fractional variants, like G38.x or G43.1.
+    for (uint8_t idx = 0; idx < (sizeof(gc_g_fractional_commands)/sizeof(gc_fractional_command_t)); idx++) {
+      if ((gc_g_fractional_commands[idx].int_value == int_value) &&
+          (gc_g_fractional_commands[idx].mantissa == mantissa)) {
+        *command = &gc_g_fractional_commands[idx].command;
+        return(STATUS_OK);
+      }
+    }
+    if (entry->flags & GC_CMD_FRACTIONAL) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported Gxx.x command]
+    if (entry->flags & GC_CMD_VALID) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [Invalid Gxx.x command]
+  }
+  if (!(entry->flags & GC_CMD_VALID)) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported G command]
+  *command = entry;
+  return(STATUS_OK);
+}
+
+/**
+  * @brief  Stores coordinate data of G10, G28.1 and G30.1. Skipped while a stored program is
+            validated, which leaves the stored data as it was.
+  * @param  uint8_t coord_select, float *coord_data
+  * @retval None
+  */
+static void gc_write_coord_data(uint8_t coord_select, float *coord_data) {
+  #ifdef PROGRAM_VALIDATION
+    if (validation_active()) { return; }
+  #endif
+  settings_write_coord_data(coord_select, coord_data);
+}
+
+/**
+  * @brief  Gives the axes of a plane: the two plane axes, in the order of the arc direction, and
+            the axis normal to it.
+  * @param  uint8_t plane_select, uint8_t *axis_0, uint8_t *axis_1, uint8_t *axis_linear
+  * @retval None
+  */
+static void gc_plane_axes(uint8_t plane_select, uint8_t *axis_0, uint8_t *axis_1, uint8_t *axis_linear) {
+  switch (plane_select) {
+    case PLANE_SELECT_XY:
+      *axis_0 = X_AXIS;
+      *axis_1 = Y_AXIS;
+      *axis_linear = Z_AXIS;
+      break;
+    case PLANE_SELECT_ZX:
+      *axis_0 = Z_AXIS;
+      *axis_1 = X_AXIS;
+      *axis_linear = Y_AXIS;
+      break;
+    default: // case PLANE_SELECT_YZ:
+      *axis_0 = Y_AXIS;
+      *axis_1 = Z_AXIS;
+      *axis_linear = X_AXIS;
+  }
+}
+
+/**
+  * @brief  Recomputes a map of program positions to machine coordinates from its rotation and
+            scaling parameters, the modes enabling them and the work offsets. The G92 and tool
+            length offsets are taken from the state.
+  * @param  gc_transform_t *transform, const gc_modal_t *modal, const float *coord_system
+  * @retval None
+  */
+static void gc_update_transform(gc_transform_t *transform, const gc_modal_t *modal, const float *coord_system) {
+  float rotation[N_AXIS][N_AXIS];
+  float scale[N_AXIS];
+  float center[N_AXIS];
+  uint8_t idx, jdx;
+  /* Work offsets, the whole map while rotation and scaling are disabled */
+  for (idx=0; idx<N_AXIS; idx++) {
+    transform->work_offset[idx] = coord_system[idx] + gc_state.coord_offset[idx];
+    if (idx == TOOL_LENGTH_OFFSET_AXIS) { transform->work_offset[idx] += gc_state.tool_length_offset; }
+    for (jdx=0; jdx<N_AXIS; jdx++) { rotation[idx][jdx] = (idx == jdx) ? 1.0 : 0.0; }
+    scale[idx] = (modal->scaling == SCALING_ENABLE) ? transform->scale[idx] : 1.0;
+  }
+  transform->active = (modal->scaling == SCALING_ENABLE) || (modal->rotation == ROTATION_ENABLE);
+  if (modal->rotation == ROTATION_ENABLE) {
+    uint8_t axis_0, axis_1, axis_linear;
+    gc_plane_axes(transform->rotation_plane, &axis_0, &axis_1, &axis_linear);
+    float angle = transform->rotation*(M_PI/180.0);
+    rotation[axis_0][axis_0] = cosf(angle);
+    rotation[axis_0][axis_1] = -sinf(angle);
+    rotation[axis_1][axis_0] = sinf(angle);
+    rotation[axis_1][axis_1] = cosf(angle);
+  }
+  /* machine = R*(S*(p - Cs) + Cs - Cr) + Cr + work offset. The inverse of R*S is S^-1*R^T. */
+  for (idx=0; idx<N_AXIS; idx++) {
+    center[idx] = (1.0 - scale[idx])*transform->scale_center[idx];
+    if (modal->rotation == ROTATION_ENABLE) { center[idx] -= transform->rotation_center[idx]; }
+  }
+  for (idx=0; idx<N_AXIS; idx++) {
+    transform->offset[idx] = transform->work_offset[idx];
+    if (modal->rotation == ROTATION_ENABLE) { transform->offset[idx] += transform->rotation_center[idx]; }
+    for (jdx=0; jdx<N_AXIS; jdx++) {
+      transform->matrix[idx][jdx] = rotation[idx][jdx]*scale[jdx];
+      transform->inverse[idx][jdx] = rotation[jdx][idx]/scale[idx];
+      transform->offset[idx] += rotation[idx][jdx]*center[jdx];
+    }
+  }
+}
+
+/**
+  * @brief  Reads the current position back as a program position, through the inverse of a map.
+  * @param  const gc_transform_t *transform, float *program, in mm
+  * @retval None
+  */
+static void gc_program_position(const gc_transform_t *transform, float *program) {
+  float delta[N_AXIS];
+  uint8_t idx, jdx;
+  /* */
+  for (idx=0; idx<N_AXIS; idx++) { delta[idx] = gc_state.position[idx] - transform->offset[idx]; }
+  for (idx=0; idx<N_AXIS; idx++) {
+    program[idx] = 0.0;
+    for (jdx=0; jdx<N_AXIS; jdx++) { program[idx] += transform->inverse[idx][jdx]*delta[jdx]; }
+  }
+}
+
+/**
+  * @brief  Converts the axis words of a block into its machine target with the offsets only:
+            absolute words add the offset, incremental words the current position, and axes
+            without word keep the current position.
+  * @param  float *target, the words in mm, returned as the target, uint8_t axis_words,
+            uint8_t distance, const float *offset
+  * @retval None
+  */
+static void gc_offset_target(float *target, uint8_t axis_words, uint8_t distance, const float *offset) {
+  for (uint8_t idx=0; idx<N_AXIS; idx++) {
+    if (bit_isfalse(axis_words,bit(idx))) { target[idx] = gc_state.position[idx]; }
+    else if (distance == DISTANCE_MODE_ABSOLUTE) { target[idx] += offset[idx]; }
+    else { target[idx] += gc_state.position[idx]; }
+  }
+}
+
+/**
+  * @brief  Converts the axis words of a block into its machine target through a map, with one
+            multiply-add per axis. Absolute words replace axes of the current program position,
+            incremental words are mapped as a move from the current position.
+  * @param  const gc_transform_t *transform, float *target, the words in mm, returned as the
+            target, uint8_t axis_words, uint8_t distance
+  * @retval None
+  */
+static void gc_transform_target(const gc_transform_t *transform, float *target, uint8_t axis_words, uint8_t distance) {
+  float program[N_AXIS];
+  uint8_t idx, jdx;
+  /* */
+  if (!transform->active) {
+    gc_offset_target(target, axis_words, distance, transform->offset);
+    return;
+  }
+  if (distance == DISTANCE_MODE_ABSOLUTE) { gc_program_position(transform, program); }
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_istrue(axis_words,bit(idx))) { program[idx] = target[idx]; }
+    else if (distance != DISTANCE_MODE_ABSOLUTE) { program[idx] = 0.0; }
+  }
+  for (idx=0; idx<N_AXIS; idx++) {
+    target[idx] = (distance == DISTANCE_MODE_ABSOLUTE) ? transform->offset[idx] : gc_state.position[idx];
+    for (jdx=0; jdx<N_AXIS; jdx++) { target[idx] += transform->matrix[idx][jdx]*program[jdx]; }
+  }
+}
+
+/**
+  * @brief  Executes a line of only axis words, optionally with F and N, under the G0 or G1 motion
+            mode, without the modal group checks and the non-modal dispatch of gc_execute_line().
+            This is the common line of surfacing and contour programs. Any other line, any state
+            that changes the meaning of the words (G93, laser mode, arcs, probing, canned modes) and
+            any word that would fail a check falls back to the full parser, so the errors are
+            reported as before. Nothing is changed until the line is known to be valid.
+  * @param  char *line
+  * @retval true if the line was executed, false to run the full parser
+  */
+static bool_g gc_execute_axis_line(char *line) {
+  float words[WORD_Z + 1];
+  uint16_t value_words = 0;
+  uint8_t char_counter = 0;
+  float value;
+  uint8_t idx;
+  /* */
+  if ((gc_state.modal.motion != MOTION_MODE_LINEAR) && (gc_state.modal.motion != MOTION_MODE_SEEK)) { return(false); }
+  if (gc_state.modal.feed_rate != FEED_RATE_MODE_UNITS_PER_MIN) { return(false); }
+  if (bit_istrue(settings.flags,BITFLAG_LASER_MODE)) { return(false); }
+  /* Import the words, only F, N and the axis words, each once and not negative for F and N */
+  while (line[char_counter] != 0) {
+    char letter = line[char_counter];
+    if ((letter < 'A') || (letter > 'Z')) { return(false); }
+    uint8_t word_bit = gc_value_words[letter - 'A'];
+    if (word_bit == GC_WORD_UNSUPPORTED) { return(false); }
+    if ((word_bit != WORD_F) && (word_bit != WORD_N) && (word_bit < WORD_X)) { return(false); }
+    char_counter++;
+    if (!read_float(line, &char_counter, &value)) { return(false); }
+    if (bit_istrue(value_words,bit(word_bit))) { return(false); }
+    if ((word_bit < WORD_X) && (value < 0.0)) { return(false); }
+    value_words |= bit(word_bit);
+    words[word_bit] = value;
+  }
+  uint8_t axis_words = value_words >> WORD_X;
+  if (!axis_words) { return(false); } // Feed rate only line, updates the state without motion
+  /* */
+  int32_t line_number = 0;
+  if (bit_istrue(value_words,bit(WORD_N))) {
+    line_number = trunc(words[WORD_N]);
+    if (line_number > MAX_LINE_NUMBER) { return(false); }
+  }
+  float feed_rate = gc_state.feed_rate;
+  if (bit_istrue(value_words,bit(WORD_F))) {
+    feed_rate = words[WORD_F];
+    if (gc_state.modal.units == UNITS_MODE_INCHES) { feed_rate *= MM_PER_INCH; }
+  }
+  if ((gc_state.modal.motion == MOTION_MODE_LINEAR) && ((int32_t)feed_rate == 0)) { return(false); }
+
+  /* Valid line, compute the target the same way as the full parser */
+  float target[N_AXIS];
+  for (idx=0; idx<N_AXIS; idx++) {
+    if (bit_isfalse(axis_words,bit(idx))) { continue; }
+    target[idx] = words[WORD_X + idx];
+    if (gc_state.modal.units == UNITS_MODE_INCHES) { target[idx] *= MM_PER_INCH; }
+  }
+  gc_transform_target(&gc_state.transform, target, axis_words, gc_state.modal.distance);
+
+  /* Execute, updating the state as STEP 4 of the full parser does for such a block */
+  plan_line_data_t plan_data;
+  memset(&plan_data,0,sizeof(plan_line_data_t));
+  gc_state.line_number = line_number;
+  #ifdef USE_LINE_NUMBERS
+    plan_data.line_number = line_number;
+  #endif
+  gc_state.feed_rate = feed_rate;
+  plan_data.feed_rate = feed_rate;
+  plan_data.spindle_speed = gc_state.spindle_speed;
+  gc_state.tool = 0; // No T word in the block
+  plan_data.condition = (gc_state.modal.spindle | gc_state.modal.coolant);
+  if (gc_state.modal.motion == MOTION_MODE_SEEK) { plan_data.condition |= PL_COND_FLAG_RAPID_MOTION; }
+  mc_line(target, &plan_data);
+  memcpy(gc_state.position, target, sizeof(target));
+  return(true);
+}
+
+/**
+  * @brief  Queues a canned cycle line motion, at rapid or at the block feed rate.
+  * @param  float *target, plan_line_data_t *pl_data, uint8_t rapid
+  * @retval None
+  */
+static void gc_canned_line(float *target, plan_line_data_t *pl_data, uint8_t rapid) {
+  uint8_t condition = pl_data->condition;
+  if (rapid) { pl_data->condition |= PL_COND_FLAG_RAPID_MOTION; }
+  mc_line(target, pl_data);
+  pl_data->condition = condition;
+}
+
+/**
+  * @brief  Expands the active G73/G81/G82/G83 canned cycle into line motions, for the gc_block.values.l
+            holes. Each hole: rapid up to the R level if below it, rapid to the hole position, rapid to R,
+            feed down to the depth, in Q increments for the peck cycles, dwell P for G82, and rapid out
+            to R with G99 or to the higher of R and the start level with G98.
+  * @param  float *target, first hole in machine coordinates, returned as the final position,
+            plan_line_data_t *pl_data, float *step, offset between repeated holes, float r_level,
+            float depth, in machine coordinates, uint8_t axis_linear, the drilling axis
+  * @retval None
+  */
+static void gc_execute_canned_cycle(float *target, plan_line_data_t *pl_data, float *step, float r_level,
+  float depth, uint8_t axis_linear) {
+  float position[N_AXIS];
+  float clear_level = r_level;
+  uint8_t motion = gc_state.modal.motion;
+  uint8_t idx;
+  /* */
+  if ((gc_state.modal.retract == RETRACT_MODE_OLD_Z) && (gc_state.canned.initial > r_level)) {
+    clear_level = gc_state.canned.initial;
+  }
+  memcpy(position, gc_state.position, sizeof(position));
+  if (position[axis_linear] < r_level) {
+    position[axis_linear] = r_level;
+    gc_canned_line(position, pl_data, true);
+  }
+  for (uint8_t hole = 0; hole < gc_block.values.l; hole++) {
+    for (idx=0; idx<N_AXIS; idx++) {
+      if (idx != axis_linear) { position[idx] = target[idx] + hole*step[idx]; }
+    }
+    gc_canned_line(position, pl_data, true);
+    if (position[axis_linear] != r_level) { // Already at R with G99
+      position[axis_linear] = r_level;
+      gc_canned_line(position, pl_data, true);
+    }
+    /* */
+    if ((motion == MOTION_MODE_DRILL_PECK) || (motion == MOTION_MODE_DRILL_CHIP_BREAK)) {
+      float bottom = r_level;
+      while (bottom > depth) {
+        if ((motion == MOTION_MODE_DRILL_PECK) && (bottom < r_level)) {
+          position[axis_linear] = min(bottom + CANNED_CYCLE_PECK_CLEARANCE, r_level);
+          gc_canned_line(position, pl_data, true); // Back down close to the previous peck
+        }
+        bottom = max(bottom - gc_state.canned.q, depth);
+        position[axis_linear] = bottom;
+        gc_canned_line(position, pl_data, false);
+        if (bottom > depth) {
+          if (motion == MOTION_MODE_DRILL_PECK) { position[axis_linear] = r_level; }
+          else { position[axis_linear] = min(bottom + CANNED_CYCLE_PECK_CLEARANCE, r_level); }
+          gc_canned_line(position, pl_data, true);
+        }
+        if (sys.abort) { return; }
+      }
+    } else {
+      position[axis_linear] = depth;
+      gc_canned_line(position, pl_data, false);
+      if (motion == MOTION_MODE_DRILL_DWELL) { mc_dwell(gc_state.canned.p); }
+    }
+    position[axis_linear] = clear_level;
+    gc_canned_line(position, pl_data, true);
+    if (sys.abort) { return; }
+  }
+  memcpy(target, position, sizeof(position));
+}
+
 /* Functions -----------------------------------------------------------------*/
 
 /* CRITICAL SECTION callbacks ------------------------------------------------*/
@@ -60,6 +592,7 @@ void gc_init(void) {
     if (!(settings_read_coord_data(gc_state.modal.coord_select,gc_state.coord_system))) {
         report_status_message(STATUS_SETTING_READ_FAIL);
     }
+    gc_update_transform(&gc_state.transform, &gc_state.modal, gc_state.coord_system);
 }
 
 // Sets g-code parser position in mm. Input in steps. Called by the system abort and hard
@@ -68,12 +601,60 @@ void gc_sync_position(void) {
     system_convert_array_steps_to_mpos(gc_state.position,sys_position);
 }
 
-// Executes one line of 0-terminated G-Code. The line is assumed to contain only uppercase
-// characters and signed floating point values (no whitespace). Comments and block delete
-// characters have been removed. In this function, all units and positions are converted and
-// exported to grbl's internal functions in terms of (mm, mm/min) and absolute machine
-// coordinates, respectively.
-uint8_t gc_execute_line(char *line) {
+#ifdef PARAMETRIC_GCODE
+/**
+  * @brief  Reads a word value of a line. Parameters, expressions and functions are compiled and
+            evaluated, plain numbers are read as they are.
+  * @param  char *line, uint8_t *char_counter, float *value
+  * @retval uint8_t status code
+  */
+static uint8_t gc_read_value(char *line, uint8_t *char_counter, float *value) {
+  uint8_t code[EXPR_CODE_SIZE];
+  uint8_t length;
+  /* */
+  if (!expr_is_value(line, *char_counter)) {
+    return(read_float(line, char_counter, value) ? STATUS_OK : STATUS_BAD_NUMBER_FORMAT);
+  }
+  uint8_t status = expr_compile(line, char_counter, code, EXPR_CODE_SIZE, &length);
+  if (status == STATUS_OK) { status = expr_evaluate(code, length, value); }
+  return(status);
+}
+
+/**
+  * @brief  Evaluates a compiled value of a pre-parsed block, stored as [code length][code].
+  * @param  const uint8_t *block, uint8_t *pos, moved past the code, float *value
+  * @retval uint8_t status code
+  */
+static uint8_t gc_evaluate_code(const uint8_t *block, uint8_t *pos, float *value) {
+  uint8_t length = block[(*pos)++];
+  uint8_t status = expr_evaluate(&block[*pos], length, value);
+  *pos += length;
+  return(status);
+}
+
+/**
+  * @brief  Adds a parameter setting of the block. #0 is read only.
+  * @param  gc_parameter_setting_t *parameter_settings, uint8_t *count, float number, float value
+  * @retval uint8_t status code
+  */
+static uint8_t gc_add_parameter_setting(gc_parameter_setting_t *parameter_settings, uint8_t *count, float number, float value) {
+  uint8_t index;
+  /* */
+  if ((expr_parameter_index(number, &index) != STATUS_OK) || (index == 0)) { return(STATUS_EXPRESSION_PARAMETER); }
+  if (*count == GC_MAX_PARAMETER_SETTINGS) { return(STATUS_EXPRESSION_INVALID); }
+  parameter_settings[*count].index = index;
+  parameter_settings[*count].value = value;
+  (*count)++;
+  return(STATUS_OK);
+}
+#endif
+
+// Executes one block, given as a line of 0-terminated G-Code or as the words pre-parsed by
+// gc_tokenize_line(). The line is assumed to contain only uppercase characters and signed floating
+// point values (no whitespace). Comments and block delete characters have been removed. In this
+// function, all units and positions are converted and exported to grbl's internal functions in
+// terms of (mm, mm/min) and absolute machine coordinates, respectively.
+static uint8_t gc_execute_block(char *line, const uint8_t *block, uint8_t block_length) {
   /* -------------------------------------------------------------------------------------
      STEP 1: Initialize parser block struct and copy current g-code state modes. The parser
      updates these modes and commands as the block line is parser and will only be used and
@@ -81,8 +662,21 @@ uint8_t gc_execute_line(char *line) {
      values struct, word tracking variables, and a non-modal commands tracker for the new
      block. This struct contains all of the necessary information to execute the block. */
 
-  memset(&gc_block, 0, sizeof(parser_block_t)); // Initialize the parser block struct.
+  // Bare axis word lines under G0/G1 skip the full parser.
+  if ((line != NULL) && (line[0] != '$') && gc_execute_axis_line(line)) { return(STATUS_OK); }
+
+  // Initialize the parser block struct. Only the values read even without their word in the block
+  // are cleared. R and Q are only read with their word or after being computed, S is loaded from
+  // the state when missing.
+  gc_block.non_modal_command = NON_MODAL_NO_ACTION;
   memcpy(&gc_block.modal,&gc_state.modal,sizeof(gc_modal_t)); // Copy current modes
+  gc_block.values.f = 0.0;
+  memset(gc_block.values.ijk, 0, sizeof(gc_block.values.ijk));
+  gc_block.values.l = 0;
+  gc_block.values.n = 0;
+  gc_block.values.p = 0.0;
+  gc_block.values.t = 0;
+  memset(gc_block.values.xyz, 0, sizeof(gc_block.values.xyz));
 
   uint8_t axis_command = AXIS_COMMAND_NONE;
   uint8_t axis_0, axis_1, axis_linear;
@@ -93,12 +687,14 @@ uint8_t gc_execute_line(char *line) {
   uint8_t ijk_words = 0; // IJK tracking
 
   // Initialize command and value words and parser flags variables.
-  uint16_t command_words = 0; // Tracks G and M command words. Also used for modal group violations.
+  uint32_t command_words = 0; // Tracks G and M command words. Also used for modal group violations.
   uint16_t value_words = 0; // Tracks value words.
   uint8_t gc_parser_flags = GC_PARSER_NONE;
+  uint8_t canned_update = false; // Block sets the canned cycle words
+  uint8_t transform_update = false; // Block changes the work offsets of the state map
 
   // Determine if the line is a jogging motion or a normal g-code block.
-  if (line[0] == '$') { // NOTE: `$J=` already parsed when passed to this function.
+  if ((line != NULL) && (line[0] == '$')) { // NOTE: `$J=` already parsed when passed to this function.
     // Set G1 and G94 enforced modes to ensure accurate error checks.
     gc_parser_flags |= GC_PARSER_JOG_MOTION;
     gc_block.modal.motion = MOTION_MODE_LINEAR;
@@ -120,225 +716,133 @@ uint8_t gc_execute_line(char *line) {
   float value;
   uint8_t int_value = 0;
   uint16_t mantissa = 0;
+  uint8_t block_pos = 0;
+  #ifdef PARAMETRIC_GCODE
+    gc_parameter_setting_t parameter_settings[GC_MAX_PARAMETER_SETTINGS];
+    uint8_t parameter_setting_count = 0;
+    uint8_t status;
+    float number;
+  #endif
   if (gc_parser_flags & GC_PARSER_JOG_MOTION) { char_counter = 3; } // Start parsing after `$J=`
   else { char_counter = 0; }
 
-  while (line[char_counter] != 0) { // Loop until no more g-code words in line.
-
-    // Import the next g-code word, expecting a letter followed by a value. Otherwise, error out.
-    letter = line[char_counter];
-    if((letter < 'A') || (letter > 'Z')) { FAIL(STATUS_EXPECTED_COMMAND_LETTER); } // [Expected word letter]
-    char_counter++;
-    if (!read_float(line, &char_counter, &value)) { FAIL(STATUS_BAD_NUMBER_FORMAT); } // [Expected word value]
-
-    // Convert values to smaller uint8 significand and mantissa values for parsing this word.
-    // NOTE: Mantissa is multiplied by 100 to catch non-integer command values. This is more
-    // accurate than the NIST gcode requirement of x10 when used for commands, but not quite
-    // accurate enough for value words that require integers to within 0.0001. This should be
-    // a good enough comprimise and catch most all non-integer errors. To make it compliant,
-    // we would simply need to change the mantissa to int16, but this add compiled flash space.
-    // Maybe update this later.
-    int_value = trunc(value);
-    mantissa =  round(100*(value - int_value)); // Compute mantissa for Gxx.x commands.
-    // NOTE: Rounding must be used to catch small floating point errors.
+  while ((line != NULL) ? (line[char_counter] != 0) : (block_pos < block_length)) { // Loop until no more g-code words in line.
+
+    if (line == NULL) {
+      // Pre-parsed word, the letter and value are checked by gc_tokenize_line().
+      letter = block[block_pos++];
+      #ifdef PARAMETRIC_GCODE
+        if (letter == '#') {
+          if ((status = gc_evaluate_code(block, &block_pos, &number)) != STATUS_OK) { FAIL(status); }
+          if ((status = gc_evaluate_code(block, &block_pos, &value)) != STATUS_OK) { FAIL(status); }
+          status = gc_add_parameter_setting(parameter_settings, &parameter_setting_count, number, value);
+          if (status != STATUS_OK) { FAIL(status); }
+          continue;
+        }
+        if (letter & GC_WORD_EXPRESSION) {
+          letter &= ~GC_WORD_EXPRESSION;
+          if ((status = gc_evaluate_code(block, &block_pos, &value)) != STATUS_OK) { FAIL(status); }
+        } else
+      #endif
+      {
+        memcpy(&value, &block[block_pos], sizeof(float));
+        block_pos += sizeof(float);
+      }
+    } else {
+      // Import the next g-code word, expecting a letter followed by a value. Otherwise, error out.
+      letter = line[char_counter];
+      #ifdef PARAMETRIC_GCODE
+        if (letter == '#') {
+          // Parameter setting, #n=value. Values of the block still read the current parameters.
+          char_counter++;
+          if ((status = gc_read_value(line, &char_counter, &number)) != STATUS_OK) { FAIL(status); }
+          if (line[char_counter++] != '=') { FAIL(STATUS_EXPRESSION_INVALID); }
+          if ((status = gc_read_value(line, &char_counter, &value)) != STATUS_OK) { FAIL(status); }
+          status = gc_add_parameter_setting(parameter_settings, &parameter_setting_count, number, value);
+          if (status != STATUS_OK) { FAIL(status); }
+          continue;
+        }
+      #endif
+      if((letter < 'A') || (letter > 'Z')) { FAIL(STATUS_EXPECTED_COMMAND_LETTER); } // [Expected word letter]
+      char_counter++;
+      #ifdef PARAMETRIC_GCODE
+        if ((status = gc_read_value(line, &char_counter, &value)) != STATUS_OK) { FAIL(status); } // [Expected word value]
+      #else
+        if (!read_float(line, &char_counter, &value)) { FAIL(STATUS_BAD_NUMBER_FORMAT); } // [Expected word value]
+      #endif
+    }
 
     // Check if the g-code word is supported or errors due to modal group violations or has
     // been repeated in the g-code block. If ok, update the command or record its value.
-    switch(letter) {
+    if ((letter == 'G') || (letter == 'M')) {
 
       /* 'G' and 'M' Command Words: Parse commands and check for modal group violations.
          NOTE: Modal group numbers are defined in Table 4 of NIST RS274-NGC v3, pg.20 */
 
-      case 'G':
-        // Determine 'G' command and its modal group
-        switch(int_value) {
-          case 10: case 28: case 30: case 92:
-            // Check for G10/28/30/92 being called with G0/1/2/3/38 on same block.
-            // * G43.1 is also an axis command but is not explicitly defined this way.
-            if (mantissa == 0) { // Ignore G28.1, G30.1, and G92.1
-              if (axis_command) { FAIL(STATUS_GCODE_AXIS_COMMAND_CONFLICT); } // [Axis word/command conflict]
-              axis_command = AXIS_COMMAND_NON_MODAL;
-            }
-            // No break. Continues to next line.
-          case 4: case 53:
-            word_bit = MODAL_GROUP_G0;
-            gc_block.non_modal_command = int_value;
-            if ((int_value == 28) || (int_value == 30) || (int_value == 92)) {
-              if (!((mantissa == 0) || (mantissa == 10))) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); }
-              gc_block.non_modal_command += mantissa;
-              mantissa = 0; // Set to zero to indicate valid non-integer G command.
-            }
-            break;
-          case 0: case 1: case 2: case 3: case 38:
-            // Check for G0/1/2/3/38 being called with G10/28/30/92 on same block.
-            // * G43.1 is also an axis command but is not explicitly defined this way.
-            if (axis_command) { FAIL(STATUS_GCODE_AXIS_COMMAND_CONFLICT); } // [Axis word/command conflict]
-            axis_command = AXIS_COMMAND_MOTION_MODE;
-            // No break. Continues to next line.
-          case 80:
-            word_bit = MODAL_GROUP_G1;
-            gc_block.modal.motion = int_value;
-            if (int_value == 38){
-              if (!((mantissa == 20) || (mantissa == 30) || (mantissa == 40) || (mantissa == 50))) {
-                FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G38.x command]
-              }
-              gc_block.modal.motion += (mantissa/10)+100;
-              mantissa = 0; // Set to zero to indicate valid non-integer G command.
-            }
-            break;
-          case 17: case 18: case 19:
-            word_bit = MODAL_GROUP_G2;
-            gc_block.modal.plane_select = int_value - 17;
-            break;
-          case 90: case 91:
-            if (mantissa == 0) {
-              word_bit = MODAL_GROUP_G3;
-              gc_block.modal.distance = int_value - 90;
-            } else {
-              word_bit = MODAL_GROUP_G4;
-              if ((mantissa != 10) || (int_value == 90)) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G90.1 not supported]
-              mantissa = 0; // Set to zero to indicate valid non-integer G command.
-              // Otherwise, arc IJK incremental mode is default. G91.1 does nothing.
-            }
-            break;
-          case 93: case 94:
-            word_bit = MODAL_GROUP_G5;
-            gc_block.modal.feed_rate = 94 - int_value;
-            break;
-          case 20: case 21:
-            word_bit = MODAL_GROUP_G6;
-            gc_block.modal.units = 21 - int_value;
-            break;
-          case 40:
-            word_bit = MODAL_GROUP_G7;
-            // NOTE: Not required since cutter radius compensation is always disabled. Only here
-            // to support G40 commands that often appear in g-code program headers to setup defaults.
-            // gc_block.modal.cutter_comp = CUTTER_COMP_DISABLE; // G40
-            break;
-          case 43: case 49:
-            word_bit = MODAL_GROUP_G8;
-            // NOTE: The NIST g-code standard vaguely states that when a tool length offset is changed,
-            // there cannot be any axis motion or coordinate offsets updated. Meaning G43, G43.1, and G49
-            // all are explicit axis commands, regardless if they require axis words or not.
-            if (axis_command) { FAIL(STATUS_GCODE_AXIS_COMMAND_CONFLICT); } // [Axis word/command conflict] }
-            axis_command = AXIS_COMMAND_TOOL_LENGTH_OFFSET;
-            if (int_value == 49) { // G49
-              gc_block.modal.tool_length = TOOL_LENGTH_OFFSET_CANCEL;
-            } else if (mantissa == 10) { // G43.1
-              gc_block.modal.tool_length = TOOL_LENGTH_OFFSET_ENABLE_DYNAMIC;
-            } else { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported G43.x command]
-            mantissa = 0; // Set to zero to indicate valid non-integer G command.
-            break;
-          case 54: case 55: case 56: case 57: case 58: case 59:
-            // NOTE: G59.x are not supported. (But their int_values would be 60, 61, and 62.)
-            word_bit = MODAL_GROUP_G12;
-            gc_block.modal.coord_select = int_value - 54; // Shift to array indexing.
-            break;
-          case 61:
-            word_bit = MODAL_GROUP_G13;
-            if (mantissa != 0) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G61.1 not supported]
-            // gc_block.modal.control = CONTROL_MODE_EXACT_PATH; // G61
-            break;
-          default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported G command]
-        }
-        if (mantissa > 0) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [Unsupported or invalid Gxx.x command]
-        // Check for more than one command per modal group violations in the current block
-        // NOTE: Variable 'word_bit' is always assigned, if the command is valid.
-        if ( bit_istrue(command_words,bit(word_bit)) ) { FAIL(STATUS_GCODE_MODAL_GROUP_VIOLATION); }
-        command_words |= bit(word_bit);
-        break;
-
-      case 'M':
-
-        // Determine 'M' command and its modal group
-        if (mantissa > 0) { FAIL(STATUS_GCODE_COMMAND_VALUE_NOT_INTEGER); } // [No Mxx.x commands]
-        switch(int_value) {
-          case 0: case 1: case 2: case 30:
-            word_bit = MODAL_GROUP_M4;
-            switch(int_value) {
-              case 0: gc_block.modal.program_flow = PROGRAM_FLOW_PAUSED; break; // Program pause
-              case 1: break; // Optional stop not supported. Ignore.
-              default: gc_block.modal.program_flow = int_value; // Program end and reset
-            }
-            break;
-          case 3: case 4: case 5:
-            word_bit = MODAL_GROUP_M7;
-            switch(int_value) {
-              case 3: gc_block.modal.spindle = SPINDLE_ENABLE_CW; break;
-              case 4: gc_block.modal.spindle = SPINDLE_ENABLE_CCW; break;
-              case 5: gc_block.modal.spindle = SPINDLE_DISABLE; break;
-            }
-            break;
-          #ifdef ENABLE_M7
-            case 7: case 8: case 9:
-          #else
-            case 8: case 9:
-          #endif
-            word_bit = MODAL_GROUP_M8;
-            switch(int_value) {
-              #ifdef ENABLE_M7
-                case 7: gc_block.modal.coolant |= COOLANT_MIST_ENABLE; break;
-              #endif
-              case 8: gc_block.modal.coolant |= COOLANT_FLOOD_ENABLE; break;
-              case 9: gc_block.modal.coolant = COOLANT_DISABLE; break; // M9 disables both M7 and M8.
-            }
-            break;
-          #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
-            case 56:
-              word_bit = MODAL_GROUP_M9;
-              gc_block.modal.override = OVERRIDE_PARKING_MOTION;
-              break;
-          #endif
-          default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); // [Unsupported M command]
-        }
+      // Convert values to smaller uint8 significand and mantissa values for parsing this word.
+      // NOTE: Mantissa is multiplied by 100 to catch non-integer command values. This is more
+      // accurate than the NIST gcode requirement of x10 when used for commands, but not quite
+      // accurate enough for value words that require integers to within 0.0001. This should be
+      // a good enough comprimise and catch most all non-integer errors. To make it compliant,
+      // we would simply need to change the mantissa to int16, but this add compiled flash space.
+      // Maybe update this later.
+      int_value = trunc(value);
+      mantissa =  round(100*(value - int_value)); // Compute mantissa for Gxx.x commands.
+      // NOTE: Rounding must be used to catch small floating point errors.
+
+      // Determine the command and its modal group from the dispatch tables.
+      const gc_command_t *command;
+      uint8_t status = gc_lookup_command(letter, int_value, mantissa, &command);
+      if (status != STATUS_OK) { FAIL(status); }
+
+      // Check for G10/28/30/92, G0/1/2/3/38 and G43.1/49 being called together on the same block.
+      if (command->flags & GC_CMD_AXIS_MASK) {
+        if (axis_command) { FAIL(STATUS_GCODE_AXIS_COMMAND_CONFLICT); } // [Axis word/command conflict]
+        axis_command = command->flags & GC_CMD_AXIS_MASK;
+      }
+      // Check for more than one command per modal group violations in the current block
+      word_bit = command->group;
+      if ( bit_istrue(command_words,bit(word_bit)) ) { FAIL(STATUS_GCODE_MODAL_GROUP_VIOLATION); }
+      command_words |= bit(word_bit);
+      // Update the block state of the modal group.
+      uint8_t *state = gc_command_state[word_bit];
+      if ((state != NULL) && !(command->flags & GC_CMD_NO_ACTION)) {
+        if (command->flags & GC_CMD_MERGE) { *state |= command->value; }
+        else { *state = command->value; }
+      }
 
-        // Check for more than one command per modal group violations in the current block
-        // NOTE: Variable 'word_bit' is always assigned, if the command is valid.
-        if ( bit_istrue(command_words,bit(word_bit)) ) { FAIL(STATUS_GCODE_MODAL_GROUP_VIOLATION); }
-        command_words |= bit(word_bit);
-        break;
-
-      // NOTE: All remaining letters assign values.
-      default:
-
-        /* Non-Command Words: This initial parsing phase only checks for repeats of the remaining
-           legal g-code words and stores their value. Error-checking is performed later since some
-           words (I,J,K,L,P,R) have multiple connotations and/or depend on the issued commands. */
-        switch(letter){
-          // case 'A': // Not supported
-          // case 'B': // Not supported
-          // case 'C': // Not supported
-          // case 'D': // Not supported
-          case 'F': word_bit = WORD_F; gc_block.values.f = value; break;
-          // case 'H': // Not supported
-          case 'I': word_bit = WORD_I; gc_block.values.ijk[X_AXIS] = value; ijk_words |= (1<<X_AXIS); break;
-          case 'J': word_bit = WORD_J; gc_block.values.ijk[Y_AXIS] = value; ijk_words |= (1<<Y_AXIS); break;
-          case 'K': word_bit = WORD_K; gc_block.values.ijk[Z_AXIS] = value; ijk_words |= (1<<Z_AXIS); break;
-          case 'L': word_bit = WORD_L; gc_block.values.l = int_value; break;
-          case 'N': word_bit = WORD_N; gc_block.values.n = trunc(value); break;
-          case 'P': word_bit = WORD_P; gc_block.values.p = value; break;
-          // NOTE: For certain commands, P value must be an integer, but none of these commands are supported.
-          // case 'Q': // Not supported
-          case 'R': word_bit = WORD_R; gc_block.values.r = value; break;
-          case 'S': word_bit = WORD_S; gc_block.values.s = value; break;
-          case 'T': word_bit = WORD_T;
-					  if (value > MAX_TOOL_NUMBER) { FAIL(STATUS_GCODE_MAX_VALUE_EXCEEDED); }
-            gc_block.values.t = int_value;
-						break;
-          case 'X': word_bit = WORD_X; gc_block.values.xyz[X_AXIS] = value; axis_words |= (1<<X_AXIS); break;
-          case 'Y': word_bit = WORD_Y; gc_block.values.xyz[Y_AXIS] = value; axis_words |= (1<<Y_AXIS); break;
-          case 'Z': word_bit = WORD_Z; gc_block.values.xyz[Z_AXIS] = value; axis_words |= (1<<Z_AXIS); break;
-          default: FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND);
-        }
+    } else {
 
-        // NOTE: Variable 'word_bit' is always assigned, if the non-command letter is valid.
-        if (bit_istrue(value_words,bit(word_bit))) { FAIL(STATUS_GCODE_WORD_REPEATED); } // [Word repeated]
-        // Check for invalid negative values for words F, N, P, T, and S.
-        // NOTE: Negative value check is done here simply for code-efficiency.
-        if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S)) ) {
-          if (value < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Word value cannot be negative]
-        }
-        value_words |= bit(word_bit); // Flag to indicate parameter assigned.
+      /* Non-Command Words: This initial parsing phase only checks for repeats of the remaining
+         legal g-code words and stores their value. Error-checking is performed later since some
+         words (I,J,K,L,P,R) have multiple connotations and/or depend on the issued commands. */
+      word_bit = gc_value_words[letter - 'A'];
+      if (word_bit == GC_WORD_UNSUPPORTED) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); }
+      float *word_value = gc_word_values[word_bit];
+      if (word_value != NULL) {
+        *word_value = value;
+        if ((word_bit >= WORD_X) && (word_bit <= WORD_Z)) { axis_words |= bit(word_bit - WORD_X); }
+        else if ((word_bit >= WORD_I) && (word_bit <= WORD_K)) { ijk_words |= bit(word_bit - WORD_I); }
+      } else if (word_bit == WORD_N) {
+        gc_block.values.n = trunc(value);
+      } else if (word_bit == WORD_L) {
+        if (value > 255) { FAIL(STATUS_GCODE_MAX_VALUE_EXCEEDED); } // [L does not fit the uint8_t value]
+        int_value = trunc(value);
+        gc_block.values.l = int_value;
+      } else { // WORD_T
+        if (value > MAX_TOOL_NUMBER) { FAIL(STATUS_GCODE_MAX_VALUE_EXCEEDED); }
+        int_value = trunc(value);
+        gc_block.values.t = int_value;
+      }
+
+      // NOTE: Variable 'word_bit' is always assigned, if the non-command letter is valid.
+      if (bit_istrue(value_words,bit(word_bit))) { FAIL(STATUS_GCODE_WORD_REPEATED); } // [Word repeated]
+      // Check for invalid negative values for words F, L, N, P, T, and S.
+      // NOTE: Negative value check is done here simply for code-efficiency.
+      if ( bit(word_bit) & (bit(WORD_F)|bit(WORD_L)|bit(WORD_N)|bit(WORD_P)|bit(WORD_T)|bit(WORD_S)) ) {
+        if (value < 0.0) { FAIL(STATUS_NEGATIVE_VALUE); } // [Word value cannot be negative]
+      }
+      value_words |= bit(word_bit); // Flag to indicate parameter assigned.
 
     }
   }
@@ -461,22 +965,7 @@ uint8_t gc_execute_line(char *line) {
   }
 
   // [11. Set active plane ]: N/A
-  switch (gc_block.modal.plane_select) {
-    case PLANE_SELECT_XY:
-      axis_0 = X_AXIS;
-      axis_1 = Y_AXIS;
-      axis_linear = Z_AXIS;
-      break;
-    case PLANE_SELECT_ZX:
-      axis_0 = Z_AXIS;
-      axis_1 = X_AXIS;
-      axis_linear = Y_AXIS;
-      break;
-    default: // case PLANE_SELECT_YZ:
-      axis_0 = Y_AXIS;
-      axis_1 = Z_AXIS;
-      axis_linear = X_AXIS;
-  }
+  gc_plane_axes(gc_block.modal.plane_select, &axis_0, &axis_1, &axis_linear);
 
   // [12. Set length units ]: N/A
   // Pre-convert XYZ coordinate values to millimeters, if applicable.
@@ -519,9 +1008,59 @@ uint8_t gc_execute_line(char *line) {
     }
   }
 
+  // [15.1 Scaling and coordinate rotation ]: G51 P and I,J,K words missing, or a zero scale. G68 R word
+  //   missing, or an axis word normal to the plane. The axis words are the absolute program position of
+  //   the center, the current program position for missing words. R is the angle in degrees.
+  // NOTE: Positions of the block are mapped with the state map, or with a copy of it when the block
+  // selects another coordinate system or changes scaling or rotation. So G69 X10 moves unrotated.
+  gc_transform_t block_transform;
+  gc_transform_t *transform = &gc_state.transform;
+  if ( bit_istrue(command_words,(bit(MODAL_GROUP_G12)|bit(MODAL_GROUP_G11)|bit(MODAL_GROUP_G16))) ) {
+    memcpy(&block_transform,&gc_state.transform,sizeof(gc_transform_t));
+    transform = &block_transform;
+    uint8_t scaling = bit_istrue(command_words,bit(MODAL_GROUP_G11)) && (gc_block.modal.scaling == SCALING_ENABLE);
+    uint8_t rotation = bit_istrue(command_words,bit(MODAL_GROUP_G16)) && (gc_block.modal.rotation == ROTATION_ENABLE);
+    if (scaling || rotation) { // G51 or G68 programmed, never both due to the axis command conflict.
+      float center[N_AXIS];
+      gc_program_position(&gc_state.transform,center);
+      for (idx=0; idx<N_AXIS; idx++) {
+        if (bit_istrue(axis_words,bit(idx))) { center[idx] = gc_block.values.xyz[idx]; }
+      }
+      if (scaling) {
+        if (bit_isfalse(value_words,bit(WORD_P)) && !ijk_words) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [P or I,J,K word missing]
+        for (idx=0; idx<N_AXIS; idx++) {
+          block_transform.scale[idx] = (bit_istrue(value_words,bit(WORD_P))) ? gc_block.values.p : 1.0;
+          if (ijk_words & bit(idx)) { block_transform.scale[idx] = gc_block.values.ijk[idx]; }
+          if (block_transform.scale[idx] == 0.0) { FAIL(STATUS_GCODE_TRANSFORM); } // [Zero scale]
+        }
+        memcpy(block_transform.scale_center,center,sizeof(center));
+        bit_false(value_words,(bit(WORD_P)|bit(WORD_I)|bit(WORD_J)|bit(WORD_K)));
+      } else {
+        if (bit_isfalse(value_words,bit(WORD_R))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [R word missing]
+        if (bit_istrue(axis_words,bit(axis_linear))) { FAIL(STATUS_GCODE_TRANSFORM); } // [Center off the plane]
+        block_transform.rotation = gc_block.values.r;
+        block_transform.rotation_plane = gc_block.modal.plane_select;
+        memcpy(block_transform.rotation_center,center,sizeof(center));
+        bit_false(value_words,bit(WORD_R));
+      }
+      // The axis words are used by the center. No motion in the block.
+      bit_false(value_words,(bit(WORD_X)|bit(WORD_Y)|bit(WORD_Z)));
+      axis_words = 0;
+      axis_command = AXIS_COMMAND_NONE;
+    }
+    gc_update_transform(&block_transform,&gc_block.modal,block_coord_system);
+  }
+
   // [16. Set path control mode ]: N/A. Only G61. G61.1 and G64 NOT SUPPORTED.
   // [17. Set distance mode ]: N/A. Only G91.1. G90.1 NOT SUPPORTED.
-  // [18. Set retract mode ]: NOT SUPPORTED.
+  // [18. Set retract mode ]: N/A. Only selects the canned cycle retract level.
+  // Canned cycles read the position words as program values, keep them before the offsets are applied.
+  float canned_words[N_AXIS];
+  float canned_r_level = 0.0;
+  float canned_depth = 0.0;
+  if (GC_MOTION_IS_CANNED(gc_block.modal.motion)) {
+    memcpy(canned_words,gc_block.values.xyz,sizeof(canned_words));
+  }
 
   // [19. Remaining non-modal actions ]: Check go to predefined position, set G10, or set axis offsets.
   // NOTE: We need to separate the non-modal commands that are axis word-using (G10/G28/G30/G92), as these
@@ -541,7 +1080,7 @@ uint8_t gc_execute_line(char *line) {
         if (gc_block.values.l == 2) {
           if (bit_istrue(value_words,bit(WORD_R))) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G10 L2 R not supported]
         } else { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [Unsupported L]
-      }
+      } else if (transform->active) { FAIL(STATUS_GCODE_TRANSFORM); } // [G10 L20 with rotation or scaling]
       bit_false(value_words,(bit(WORD_L)|bit(WORD_P)));
 
       // Determine coordinate system to change and try to load from EEPROM.
@@ -568,8 +1107,9 @@ uint8_t gc_execute_line(char *line) {
       }
       break;
     case NON_MODAL_SET_COORDINATE_OFFSET:
-      // [G92 Errors]: No axis words.
+      // [G92 Errors]: No axis words. Rotation or scaling enabled.
       if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
+      if (transform->active) { FAIL(STATUS_GCODE_TRANSFORM); } // [G92 with rotation or scaling]
 
       // Update axes defined only in block. Offsets current system to defined value. Does not update when
       // active coordinate system is selected, but is still active unless G92.1 disables it.
@@ -587,27 +1127,21 @@ uint8_t gc_execute_line(char *line) {
     default:
 
       // At this point, the rest of the explicit axis commands treat the axis values as the traditional
-      // target position with the coordinate system offsets, G92 offsets, absolute override, and distance
-      // modes applied. This includes the motion mode commands. We can now pre-compute the target position.
-      // NOTE: Tool offsets may be appended to these conversions when/if this feature is added.
+      // target position with the coordinate system offsets, G92 offsets, tool length offset, scaling,
+      // rotation, absolute override, and distance modes applied. This includes the motion mode commands.
+      // We can now pre-compute the target position.
       if (axis_command != AXIS_COMMAND_TOOL_LENGTH_OFFSET ) { // TLO block any axis command.
         if (axis_words) {
-          for (idx=0; idx<N_AXIS; idx++) { // Axes indices are consistent, so loop may be used to save flash space.
-            if ( bit_isfalse(axis_words,bit(idx)) ) {
-              gc_block.values.xyz[idx] = gc_state.position[idx]; // No axis word in block. Keep same axis position.
-            } else {
-              // Update specified value according to distance mode or ignore if absolute override is active.
-              // NOTE: G53 is never active with G28/30 since they are in the same modal group.
-              if (gc_block.non_modal_command != NON_MODAL_ABSOLUTE_OVERRIDE) {
-                // Apply coordinate offsets based on distance mode.
-                if (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE) {
-                  gc_block.values.xyz[idx] += block_coord_system[idx] + gc_state.coord_offset[idx];
-                  if (idx == TOOL_LENGTH_OFFSET_AXIS) { gc_block.values.xyz[idx] += gc_state.tool_length_offset; }
-                } else {  // Incremental mode
-                  gc_block.values.xyz[idx] += gc_state.position[idx];
-                }
-              }
+          // NOTE: G53 is never active with G28/30 since they are in the same modal group.
+          if (gc_block.non_modal_command == NON_MODAL_ABSOLUTE_OVERRIDE) {
+            for (idx=0; idx<N_AXIS; idx++) { // Machine coordinates, in either distance mode.
+              if (bit_isfalse(axis_words,bit(idx))) { gc_block.values.xyz[idx] = gc_state.position[idx]; }
             }
+          } else if (gc_parser_flags & GC_PARSER_JOG_MOTION) {
+            // Jogging moves along the machine axes, with the work offsets only.
+            gc_offset_target(gc_block.values.xyz, axis_words, gc_block.modal.distance, transform->work_offset);
+          } else {
+            gc_transform_target(transform, gc_block.values.xyz, axis_words, gc_block.modal.distance);
           }
         }
       }
@@ -679,7 +1213,7 @@ uint8_t gc_execute_line(char *line) {
           if (!axis_words) { axis_command = AXIS_COMMAND_NONE; }
           break;
         case MOTION_MODE_CW_ARC:
-          gc_parser_flags |= GC_PARSER_ARC_IS_CLOCKWISE; // No break intentional.
+          gc_parser_flags |= GC_PARSER_ARC_IS_CLOCKWISE; // Falls through.
         case MOTION_MODE_CCW_ARC:
           // [G2/3 Errors All-Modes]: Feed rate undefined.
           // [G2/3 Radius-Mode Errors]: No axis words in selected plane. Target point is same as current.
@@ -690,6 +1224,16 @@ uint8_t gc_execute_line(char *line) {
 
           if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
           if (!(axis_words & (bit(axis_0)|bit(axis_1)))) { FAIL(STATUS_GCODE_NO_AXIS_WORDS_IN_PLANE); } // [No axis words in plane]
+          // Arcs stay circular only in the rotation plane and with equal scales of the plane axes. The
+          // radius and offsets are program values, mapped with the plane part of the matrix.
+          if (transform->active) {
+            if ((gc_block.modal.rotation == ROTATION_ENABLE) && (transform->rotation_plane != gc_block.modal.plane_select)) {
+              FAIL(STATUS_GCODE_TRANSFORM); // [Arc off the rotation plane]
+            }
+            if ((gc_block.modal.scaling == SCALING_ENABLE) && (transform->scale[axis_0] != transform->scale[axis_1])) {
+              FAIL(STATUS_GCODE_TRANSFORM); // [Arc with unequal plane scales]
+            }
+          }
 
           // Calculate the change in position along each selected axis
           float x,y;
@@ -702,6 +1246,9 @@ uint8_t gc_execute_line(char *line) {
 
             // Convert radius value to proper units.
             if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.values.r *= MM_PER_INCH; }
+            if (transform->active) {
+              gc_block.values.r *= hypot_f(transform->matrix[axis_0][axis_0], transform->matrix[axis_1][axis_0]);
+            }
             /*  We need to calculate the center of the circle that has the designated radius and passes
                 through both the current position and the target position. This method calculates the following
                 set of equations where [x,y] is the vector from current to target position, d == magnitude of
@@ -798,6 +1345,12 @@ uint8_t gc_execute_line(char *line) {
                 if (ijk_words & bit(idx)) { gc_block.values.ijk[idx] *= MM_PER_INCH; }
               }
             }
+            if (transform->active) {
+              float i = gc_block.values.ijk[axis_0];
+              float j = gc_block.values.ijk[axis_1];
+              gc_block.values.ijk[axis_0] = transform->matrix[axis_0][axis_0]*i + transform->matrix[axis_0][axis_1]*j;
+              gc_block.values.ijk[axis_1] = transform->matrix[axis_1][axis_0]*i + transform->matrix[axis_1][axis_1]*j;
+            }
 
             // Arc radius from center to target
             x -= gc_block.values.ijk[axis_0]; // Delta x between circle center and target
@@ -816,7 +1369,7 @@ uint8_t gc_execute_line(char *line) {
           }
           break;
         case MOTION_MODE_PROBE_TOWARD_NO_ERROR: case MOTION_MODE_PROBE_AWAY_NO_ERROR:
-          gc_parser_flags |= GC_PARSER_PROBE_IS_NO_ERROR; // No break intentional.
+          gc_parser_flags |= GC_PARSER_PROBE_IS_NO_ERROR; // Falls through.
         case MOTION_MODE_PROBE_TOWARD: case MOTION_MODE_PROBE_AWAY:
           if ((gc_block.modal.motion == MOTION_MODE_PROBE_AWAY) ||
               (gc_block.modal.motion == MOTION_MODE_PROBE_AWAY_NO_ERROR)) { gc_parser_flags |= GC_PARSER_PROBE_IS_AWAY; }
@@ -827,6 +1380,81 @@ uint8_t gc_execute_line(char *line) {
           if (!axis_words) { FAIL(STATUS_GCODE_NO_AXIS_WORDS); } // [No axis words]
           if (isequal_position_vector(gc_state.position, gc_block.values.xyz)) { FAIL(STATUS_GCODE_INVALID_TARGET); } // [Invalid target]
           break;
+        case MOTION_MODE_DRILL_CHIP_BREAK: case MOTION_MODE_DRILL:
+        case MOTION_MODE_DRILL_DWELL: case MOTION_MODE_DRILL_PECK:
+          // [G73/G81-83 Errors]: Inverse time mode. R or depth word missing since the first cycle. Q missing
+          //   or not positive for G73/G83. L is zero. The R level is below the hole depth.
+          // NOTE: The hole is drilled along the axis normal to the plane. R, depth, Q and P are kept in
+          // gc_state.canned while the cycle modes stay active, so following blocks only need the position.
+          if (gc_block.modal.feed_rate == FEED_RATE_MODE_INVERSE_TIME) { FAIL(STATUS_GCODE_UNSUPPORTED_COMMAND); } // [G93 canned cycle]
+          if ((gc_block.modal.rotation == ROTATION_ENABLE) && (transform->rotation_plane != gc_block.modal.plane_select)) {
+            FAIL(STATUS_GCODE_TRANSFORM); // [Drilling axis rotated]
+          }
+          canned_update = true;
+          if (GC_MOTION_IS_CANNED(gc_state.modal.motion)) {
+            memcpy(&gc_block.canned,&gc_state.canned,sizeof(gc_canned_t));
+          } else { // First cycle, start level for G98
+            memset(&gc_block.canned,0,sizeof(gc_canned_t));
+            gc_block.canned.initial = gc_state.position[axis_linear];
+          }
+          if (!axis_words) { axis_command = AXIS_COMMAND_NONE; break; } // Cycle selected, no hole
+
+          if (bit_istrue(value_words,bit(WORD_R))) {
+            gc_block.canned.r = gc_block.values.r;
+            if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.canned.r *= MM_PER_INCH; }
+            gc_block.canned.words |= bit(WORD_R);
+            bit_false(value_words,bit(WORD_R));
+          }
+          if (bit_istrue(axis_words,bit(axis_linear))) {
+            gc_block.canned.z = canned_words[axis_linear];
+            gc_block.canned.words |= bit(WORD_Z);
+          }
+          if ((gc_block.canned.words & (bit(WORD_R)|bit(WORD_Z))) != (bit(WORD_R)|bit(WORD_Z))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [R or depth word missing]
+          if ((gc_block.modal.motion == MOTION_MODE_DRILL_PECK) || (gc_block.modal.motion == MOTION_MODE_DRILL_CHIP_BREAK)) {
+            if (bit_istrue(value_words,bit(WORD_Q))) {
+              if (gc_block.values.q <= 0.0) { FAIL(STATUS_GCODE_CANNED_CYCLE); } // [Q not positive]
+              gc_block.canned.q = gc_block.values.q;
+              if (gc_block.modal.units == UNITS_MODE_INCHES) { gc_block.canned.q *= MM_PER_INCH; }
+              gc_block.canned.words |= bit(WORD_Q);
+              bit_false(value_words,bit(WORD_Q));
+            }
+            if (bit_isfalse(gc_block.canned.words,bit(WORD_Q))) { FAIL(STATUS_GCODE_VALUE_WORD_MISSING); } // [Q word missing]
+          }
+          if ((gc_block.modal.motion == MOTION_MODE_DRILL_DWELL) && bit_istrue(value_words,bit(WORD_P))) {
+            gc_block.canned.p = gc_block.values.p; // Without P, the last or no dwell
+            bit_false(value_words,bit(WORD_P));
+          }
+          if (bit_istrue(value_words,bit(WORD_L))) {
+            if (gc_block.values.l == 0) { FAIL(STATUS_GCODE_CANNED_CYCLE); } // [L is zero]
+            bit_false(value_words,bit(WORD_L));
+          } else {
+            gc_block.values.l = 1;
+          }
+
+          // Compute the R level and the depth in machine coordinates. In incremental mode, R is relative
+          // to the start position and the depth relative to R. The drilling axis is only scaled.
+          float axis_scale = transform->matrix[axis_linear][axis_linear];
+          if (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE) {
+            canned_r_level = axis_scale*gc_block.canned.r + transform->offset[axis_linear];
+            canned_depth = axis_scale*gc_block.canned.z + transform->offset[axis_linear];
+          } else {
+            canned_r_level = gc_state.position[axis_linear] + axis_scale*gc_block.canned.r;
+            canned_depth = canned_r_level + axis_scale*gc_block.canned.z;
+          }
+          if (canned_r_level < canned_depth) { FAIL(STATUS_GCODE_CANNED_CYCLE); } // [R below depth]
+          // Repeated holes are offset by the position words in incremental mode only, mapped as moves.
+          for (idx=0; idx<N_AXIS; idx++) {
+            if ((idx == axis_linear) || (gc_block.modal.distance == DISTANCE_MODE_ABSOLUTE)) { canned_words[idx] = 0.0; }
+          }
+          if (transform->active) {
+            float step[N_AXIS];
+            memcpy(step,canned_words,sizeof(step));
+            for (idx=0; idx<N_AXIS; idx++) {
+              canned_words[idx] = 0.0;
+              for (uint8_t jdx=0; jdx<N_AXIS; jdx++) { canned_words[idx] += transform->matrix[idx][jdx]*step[jdx]; }
+            }
+          }
+          break;
       }
     }
   }
@@ -850,6 +1478,13 @@ uint8_t gc_execute_line(char *line) {
      need to update the state and execute the block according to the order-of-execution.
   */
 
+  #ifdef PARAMETRIC_GCODE
+    // Parameter settings take effect after all values of the block are read.
+    for (uint8_t idx = 0; idx < parameter_setting_count; idx++) {
+      expr_parameters[parameter_settings[idx].index] = parameter_settings[idx].value;
+    }
+  #endif
+
   // Initialize planner data struct for motion blocks.
   plan_line_data_t plan_data;
   plan_line_data_t *pl_data = &plan_data;
@@ -998,6 +1633,7 @@ uint8_t gc_execute_line(char *line) {
     if ( (int32_t)gc_state.tool_length_offset != (int32_t)gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS] ) {
       gc_state.tool_length_offset = gc_block.values.xyz[TOOL_LENGTH_OFFSET_AXIS];
       system_flag_wco_change();
+      transform_update = true;
     }
   }
 
@@ -1014,16 +1650,18 @@ uint8_t gc_execute_line(char *line) {
   // [17. Set distance mode ]:
   gc_state.modal.distance = gc_block.modal.distance;
 
-  // [18. Set retract mode ]: NOT SUPPORTED
+  // [18. Set retract mode ]:
+  gc_state.modal.retract = gc_block.modal.retract;
 
   // [19. Go to predefined position, Set G10, or Set axis offsets ]:
   switch(gc_block.non_modal_command) {
     case NON_MODAL_SET_COORDINATE_DATA:
-      settings_write_coord_data(coord_select,gc_block.values.ijk);
+      gc_write_coord_data(coord_select,gc_block.values.ijk);
       // Update system coordinate system if currently active.
       if (gc_state.modal.coord_select == coord_select) {
         memcpy(gc_state.coord_system,gc_block.values.ijk,N_AXIS*sizeof(float));
         system_flag_wco_change();
+        transform_update = true;
       }
       break;
     case NON_MODAL_GO_HOME_0: case NON_MODAL_GO_HOME_1:
@@ -1035,26 +1673,36 @@ uint8_t gc_execute_line(char *line) {
       memcpy(gc_state.position, gc_block.values.ijk, N_AXIS*sizeof(float));
       break;
     case NON_MODAL_SET_HOME_0:
-      settings_write_coord_data(SETTING_INDEX_G28,gc_state.position);
+      gc_write_coord_data(SETTING_INDEX_G28,gc_state.position);
       break;
     case NON_MODAL_SET_HOME_1:
-      settings_write_coord_data(SETTING_INDEX_G30,gc_state.position);
+      gc_write_coord_data(SETTING_INDEX_G30,gc_state.position);
       break;
     case NON_MODAL_SET_COORDINATE_OFFSET:
       memcpy(gc_state.coord_offset,gc_block.values.xyz,sizeof(gc_block.values.xyz));
       system_flag_wco_change();
+      transform_update = true;
       break;
     case NON_MODAL_RESET_COORDINATE_OFFSET:
       clear_axis_vector_float(gc_state.coord_offset); // Disable G92 offsets by zeroing offset vector.
       system_flag_wco_change();
+      transform_update = true;
       break;
   }
 
+  // [19.1 Scaling and coordinate rotation ]: Keep the map of the block, and recompute the map upon a change
+  // of the offsets in this block. Following blocks then map their targets without further additions.
+  gc_state.modal.scaling = gc_block.modal.scaling;
+  gc_state.modal.rotation = gc_block.modal.rotation;
+  if (transform != &gc_state.transform) { memcpy(&gc_state.transform,transform,sizeof(gc_transform_t)); }
+  if (transform_update) { gc_update_transform(&gc_state.transform,&gc_state.modal,gc_state.coord_system); }
+
 
   // [20. Motion modes ]:
   // NOTE: Commands G10,G28,G30,G92 lock out and prevent axis words from use in motion modes.
   // Enter motion modes only if there are axis words or a motion mode command word in the block.
   gc_state.modal.motion = gc_block.modal.motion;
+  if (canned_update) { memcpy(&gc_state.canned,&gc_block.canned,sizeof(gc_canned_t)); }
   if (gc_state.modal.motion != MOTION_MODE_NONE) {
     if (axis_command == AXIS_COMMAND_MOTION_MODE) {
       uint8_t gc_update_pos = GC_UPDATE_POS_TARGET;
@@ -1066,6 +1714,9 @@ uint8_t gc_execute_line(char *line) {
       } else if ((gc_state.modal.motion == MOTION_MODE_CW_ARC) || (gc_state.modal.motion == MOTION_MODE_CCW_ARC)) {
         mc_arc(gc_block.values.xyz, pl_data, gc_state.position, gc_block.values.ijk, gc_block.values.r,
             axis_0, axis_1, axis_linear, bit_istrue(gc_parser_flags,GC_PARSER_ARC_IS_CLOCKWISE));
+      } else if (GC_MOTION_IS_CANNED(gc_state.modal.motion)) {
+        // NOTE: gc_block.values.xyz is returned as the position after the last hole.
+        gc_execute_canned_cycle(gc_block.values.xyz, pl_data, canned_words, canned_r_level, canned_depth, axis_linear);
       } else {
         // NOTE: gc_block.values.xyz is returned from mc_probe_cycle with the updated position value. So
         // upon a successful probing cycle, the machine position and the returned value should be the same.
@@ -1102,12 +1753,15 @@ uint8_t gc_execute_line(char *line) {
       // LinuxCNC's program end descriptions and testing. Only modal groups [G-code 1,2,3,5,7,12]
       // and [M-code 7,8,9] reset to [G1,G17,G90,G94,G40,G54,M5,M9,M48]. The remaining modal groups
       // [G-code 4,6,8,10,13,14,15] and [M-code 4,5,6] and the modal words [F,S,T,H] do not reset.
+      // Scaling and rotation [G-code 11,16] are set up per job, so they are canceled as well.
       gc_state.modal.motion = MOTION_MODE_LINEAR;
       gc_state.modal.plane_select = PLANE_SELECT_XY;
       gc_state.modal.distance = DISTANCE_MODE_ABSOLUTE;
       gc_state.modal.feed_rate = FEED_RATE_MODE_UNITS_PER_MIN;
       // gc_state.modal.cutter_comp = CUTTER_COMP_DISABLE; // Not supported.
       gc_state.modal.coord_select = 0; // G54
+      gc_state.modal.scaling = SCALING_DISABLE; // G50
+      gc_state.modal.rotation = ROTATION_DISABLE; // G69
       gc_state.modal.spindle = SPINDLE_DISABLE;
       gc_state.modal.coolant = COOLANT_DISABLE;
       #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
@@ -1131,6 +1785,7 @@ uint8_t gc_execute_line(char *line) {
         spindle_set_state(SPINDLE_DISABLE,0.0);
         coolant_set_state(COOLANT_DISABLE);
       }
+      gc_update_transform(&gc_state.transform,&gc_state.modal,gc_state.coord_system);
       report_feedback_message(MESSAGE_PROGRAM_END);
     }
     gc_state.modal.program_flow = PROGRAM_FLOW_RUNNING; // Reset program flow.
@@ -1141,28 +1796,116 @@ uint8_t gc_execute_line(char *line) {
   return(STATUS_OK);
 }
 
+/**
+  * @brief  Executes one line of 0-terminated G-Code, see gc_execute_block().
+  * @param  char *line
+  * @retval uint8_t status code
+  */
+uint8_t gc_execute_line(char *line) {
+  return(gc_execute_block(line, NULL, 0));
+}
+
+/**
+  * @brief  Executes one block of words pre-parsed by gc_tokenize_line(), with the same checks and
+            results as the line itself. Replays stored blocks without parsing their text again.
+  * @param  const uint8_t *block, uint8_t length, bytes of the block
+  * @retval uint8_t status code
+  */
+uint8_t gc_execute_words(const uint8_t *block, uint8_t length) {
+  return(gc_execute_block(NULL, block, length));
+}
+
+#ifdef PARAMETRIC_GCODE
+/**
+  * @brief  Compiles a value of a line and appends it to a pre-parsed block, as [code length][code].
+  * @param  char *line, uint8_t *char_counter, uint8_t *block, uint8_t max_length, uint8_t *length
+  * @retval uint8_t status code, STATUS_OVERFLOW if the block is full
+  */
+static uint8_t gc_tokenize_code(char *line, uint8_t *char_counter, uint8_t *block, uint8_t max_length, uint8_t *length) {
+  uint8_t code[EXPR_CODE_SIZE];
+  uint8_t code_length;
+  /* */
+  uint8_t status = expr_compile(line, char_counter, code, EXPR_CODE_SIZE, &code_length);
+  if (status != STATUS_OK) { return(status); }
+  if ((max_length - *length) < (1 + code_length)) { return(STATUS_OVERFLOW); }
+  block[(*length)++] = code_length;
+  memcpy(&block[*length], code, code_length);
+  *length += code_length;
+  return(STATUS_OK);
+}
+#endif
+
+/**
+  * @brief  Splits a line of G-Code into a block of its letter and value words, without executing
+            it. The word syntax is checked as by gc_execute_line(), everything else upon execution.
+            Values of parametric g-code are stored compiled, and evaluated upon each execution.
+  * @param  char *line, uint8_t *block, uint8_t max_length, uint8_t *length, bytes of the block
+  * @retval uint8_t STATUS_OK, a word syntax status code or STATUS_OVERFLOW with more than
+            max_length bytes
+  */
+uint8_t gc_tokenize_line(char *line, uint8_t *block, uint8_t max_length, uint8_t *length) {
+  uint8_t char_counter = 0;
+  gc_word_t word;
+  float value;
+  #ifdef PARAMETRIC_GCODE
+    uint8_t status;
+  #endif
+  /* */
+  *length = 0;
+  while (line[char_counter] != 0) {
+    word.letter = line[char_counter];
+    #ifdef PARAMETRIC_GCODE
+      if (word.letter == '#') { // Parameter setting, #n=value
+        char_counter++;
+        if (*length == max_length) { FAIL(STATUS_OVERFLOW); }
+        block[(*length)++] = '#';
+        if ((status = gc_tokenize_code(line, &char_counter, block, max_length, length)) != STATUS_OK) { FAIL(status); }
+        if (line[char_counter++] != '=') { FAIL(STATUS_EXPRESSION_INVALID); }
+        if ((status = gc_tokenize_code(line, &char_counter, block, max_length, length)) != STATUS_OK) { FAIL(status); }
+        continue;
+      }
+    #endif
+    if ((word.letter < 'A') || (word.letter > 'Z')) { FAIL(STATUS_EXPECTED_COMMAND_LETTER); } // [Expected word letter]
+    char_counter++;
+    #ifdef PARAMETRIC_GCODE
+      if (expr_is_value(line, char_counter)) {
+        uint8_t start = *length;
+        if (*length == max_length) { FAIL(STATUS_OVERFLOW); }
+        block[(*length)++] = word.letter | GC_WORD_EXPRESSION;
+        if ((status = gc_tokenize_code(line, &char_counter, block, max_length, length)) != STATUS_OK) { FAIL(status); }
+        if (!expr_constant(&block[start + 2], block[start + 1], &value)) { continue; }
+        *length = start; // Constant, stored as a plain word
+      } else
+    #endif
+    if (!read_float(line, &char_counter, &value)) { FAIL(STATUS_BAD_NUMBER_FORMAT); } // [Expected word value]
+    if ((*length + sizeof(gc_word_t)) > max_length) { FAIL(STATUS_OVERFLOW); }
+    word.value = value;
+    memcpy(&block[*length], &word, sizeof(gc_word_t));
+    *length += sizeof(gc_word_t);
+  }
+  return(STATUS_OK);
+}
+
 /*
   Not supported:
 
-  - Canned cycles
   - Tool radius compensation
   - A,B,C-axes
-  - Evaluation of expressions
-  - Variables
+  - Evaluation of expressions (*)
+  - Variables (*)
   - Override control (TBD)
   - Tool changes
   - Switches
 
    (*) Indicates optional parameter, enabled through config.h and re-compile
    group 0 = {G92.2, G92.3} (Non modal: Cancel and re-enable G92 offsets)
-   group 1 = {G81 - G89} (Motion modes: Canned cycles)
+   group 1 = {G84 - G89} (Motion modes: Canned cycles, G73 and G81-G83 are supported)
    group 4 = {M1} (Optional stop, ignored)
    group 6 = {M6} (Tool change)
    group 7 = {G41, G42} cutter radius compensation (G40 is supported)
    group 8 = {G43} tool length offset (G43.1/G49 are supported)
    group 8 = {M7*} enable mist coolant (* Compile-option)
    group 9 = {M48, M49, M56*} enable/disable override switches (* Compile-option)
-   group 10 = {G98, G99} return mode canned cycles
    group 13 = {G61.1, G64} path control mode (G61 is supported)
 */
 
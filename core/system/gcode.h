@@ -24,7 +24,7 @@
 // and are similar/identical to other g-code interpreters by manufacturers (Haas,Fanuc,Mazak,etc).
 // NOTE: Modal group define values must be sequential and starting from zero.
 #define MODAL_GROUP_G0 0 // [G4,G10,G28,G28.1,G30,G30.1,G53,G92,G92.1] Non-modal
-#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G80] Motion
+#define MODAL_GROUP_G1 1 // [G0,G1,G2,G3,G38.2,G38.3,G38.4,G38.5,G73,G80,G81,G82,G83] Motion
 #define MODAL_GROUP_G2 2 // [G17,G18,G19] Plane selection
 #define MODAL_GROUP_G3 3 // [G90,G91] Distance mode
 #define MODAL_GROUP_G4 4 // [G91.1] Arc IJK distance mode
@@ -34,11 +34,15 @@
 #define MODAL_GROUP_G8 8 // [G43.1,G49] Tool length offset
 #define MODAL_GROUP_G12 9 // [G54,G55,G56,G57,G58,G59] Coordinate system selection
 #define MODAL_GROUP_G13 10 // [G61] Control mode
+#define MODAL_GROUP_G10 11 // [G98,G99] Canned cycle return mode
 
-#define MODAL_GROUP_M4 11  // [M0,M1,M2,M30] Stopping
-#define MODAL_GROUP_M7 12 // [M3,M4,M5] Spindle turning
-#define MODAL_GROUP_M8 13 // [M7,M8,M9] Coolant control
-#define MODAL_GROUP_M9 14 // [M56] Override control
+#define MODAL_GROUP_M4 12  // [M0,M1,M2,M30] Stopping
+#define MODAL_GROUP_M7 13 // [M3,M4,M5] Spindle turning
+#define MODAL_GROUP_M8 14 // [M7,M8,M9] Coolant control
+#define MODAL_GROUP_M9 15 // [M56] Override control
+
+#define MODAL_GROUP_G11 16 // [G50,G51] Scaling
+#define MODAL_GROUP_G16 17 // [G68,G69] Coordinate rotation
 
 // Define command actions for within execution-type modal groups (motion, stopping, non-modal). Used
 // internally by the parser to know which command to execute.
@@ -69,6 +73,10 @@
 #define MOTION_MODE_PROBE_AWAY 142 // G38.4 (Do not alter value)
 #define MOTION_MODE_PROBE_AWAY_NO_ERROR 143 // G38.5 (Do not alter value)
 #define MOTION_MODE_NONE 80 // G80 (Do not alter value)
+#define MOTION_MODE_DRILL_CHIP_BREAK 73 // G73 (Do not alter value)
+#define MOTION_MODE_DRILL 81 // G81 (Do not alter value)
+#define MOTION_MODE_DRILL_DWELL 82 // G82 (Do not alter value)
+#define MOTION_MODE_DRILL_PECK 83 // G83 (Do not alter value)
 
 // Modal Group G2: Plane select
 #define PLANE_SELECT_XY 0 // G17 (Default: Must be zero)
@@ -82,6 +90,18 @@
 // Modal Group G4: Arc IJK distance mode
 #define DISTANCE_ARC_MODE_INCREMENTAL 0 // G91.1 (Default: Must be zero)
 
+// Modal Group G10: Canned cycle return mode
+#define RETRACT_MODE_OLD_Z 0 // G98 (Default: Must be zero)
+#define RETRACT_MODE_R 1 // G99 (Do not alter value)
+
+// Modal Group G11: Scaling
+#define SCALING_DISABLE 0 // G50 (Default: Must be zero)
+#define SCALING_ENABLE 1 // G51 (Do not alter value)
+
+// Modal Group G16: Coordinate rotation
+#define ROTATION_DISABLE 0 // G69 (Default: Must be zero)
+#define ROTATION_ENABLE 1 // G68 (Do not alter value)
+
 // Modal Group M4: Program flow
 #define PROGRAM_FLOW_RUNNING 0 // (Default: Must be zero)
 #define PROGRAM_FLOW_PAUSED 3 // M0
@@ -137,12 +157,13 @@
 #define WORD_L  4
 #define WORD_N  5
 #define WORD_P  6
-#define WORD_R  7
-#define WORD_S  8
-#define WORD_T  9
-#define WORD_X  10
-#define WORD_Y  11
-#define WORD_Z  12
+#define WORD_Q  7
+#define WORD_R  8
+#define WORD_S  9
+#define WORD_T  10
+#define WORD_X  11
+#define WORD_Y  12
+#define WORD_Z  13
 
 // Define g-code parser position updating flags
 #define GC_UPDATE_POS_TARGET   0 // Must be zero
@@ -175,7 +196,7 @@
 /* Exported typedef ----------------------------------------------------------*/
 // NOTE: When this struct is zeroed, the above defines set the defaults for the system.
 typedef struct {
-  uint8_t motion;          // {G0,G1,G2,G3,G38.2,G80}
+  uint8_t motion;          // {G0,G1,G2,G3,G38.2,G73,G80,G81,G82,G83}
   uint8_t feed_rate;       // {G93,G94}
   uint8_t units;           // {G20,G21}
   uint8_t distance;        // {G90,G91}
@@ -184,6 +205,9 @@ typedef struct {
   // uint8_t cutter_comp;  // {G40} NOTE: Don't track. Only default supported.
   uint8_t tool_length;     // {G43.1,G49}
   uint8_t coord_select;    // {G54,G55,G56,G57,G58,G59}
+  uint8_t retract;         // {G98,G99}
+  uint8_t scaling;         // {G50,G51}
+  uint8_t rotation;        // {G68,G69}
   // uint8_t control;      // {G61} NOTE: Don't track. Only default supported.
   uint8_t program_flow;    // {M0,M1,M2,M30}
   uint8_t coolant;         // {M7,M8,M9}
@@ -197,7 +221,7 @@ typedef struct {
   uint8_t l;       // G10 or canned cycles parameters
   int32_t n;       // Line number
   float p;         // G10 or dwell parameters
-  // float q;      // G82 peck drilling
+  float q;         // G83 and G73 peck increment
   float r;         // Arc radius
   float s;         // Spindle speed
   uint8_t t;       // Tool selection
@@ -205,6 +229,34 @@ typedef struct {
 } gc_values_t;
 
 
+// Canned cycle words kept from block to block while a cycle motion mode stays active. Lengths are
+// program values in mm, applied with the offsets and the distance mode of each block.
+typedef struct {
+  float r;                      // R retract level, absolute or incremental from the start position
+  float z;                      // Depth word of the drilling axis, absolute or incremental from R
+  float q;                      // G83/G73 peck increment
+  float p;                      // G82 dwell, seconds
+  float initial;                // Drilling axis machine position before the first cycle, the G98 level
+  uint16_t words;               // Words set since the first cycle, bit(WORD_x), the depth as WORD_Z
+} gc_canned_t;
+
+// Map of program positions to machine coordinates: G51 scaling about its center, then G68 rotation
+// about its center, then the work offsets. All are fused into one matrix and one offset, recomputed
+// by gc_update_transform() only when a mode or an offset changes, so each target takes one
+// multiply-add per axis: machine = matrix*program + offset.
+typedef struct {
+  float scale[N_AXIS];            // G51 factor of each axis
+  float scale_center[N_AXIS];     // G51 center, program position in mm
+  float rotation;                 // G68 angle in degrees, counterclockwise in the rotation plane
+  float rotation_center[N_AXIS];  // G68 center, program position in mm. Only the plane axes are used.
+  uint8_t rotation_plane;         // Plane selected when G68 was programmed, {G17,G18,G19}
+  uint8_t active;                 // Rotation or scaling enabled, otherwise matrix is the identity
+  float matrix[N_AXIS][N_AXIS];   // Scaling, then rotation
+  float inverse[N_AXIS][N_AXIS];  // Inverse of matrix, to read program positions back
+  float offset[N_AXIS];           // Translation of the centers plus the work offset
+  float work_offset[N_AXIS];      // Sum of the G54+ coordinate system, G92 and tool length offsets
+} gc_transform_t;
+
 typedef struct {
   gc_modal_t modal;
 
@@ -220,6 +272,8 @@ typedef struct {
   float coord_offset[N_AXIS];    // Retains the G92 coordinate offset (work coordinates) relative to
                                  // machine zero in mm. Non-persistent. Cleared upon reset and boot.
   float tool_length_offset;      // Tracks tool length offset value when enabled.
+  gc_transform_t transform;      // Rotation, scaling and work offsets fused, see gc_update_transform()
+  gc_canned_t canned;            // Canned cycle words, valid while a cycle motion mode is active
 } parser_state_t;
 extern parser_state_t gc_state;
 
@@ -228,12 +282,28 @@ typedef struct {
   uint8_t non_modal_command;
   gc_modal_t modal;
   gc_values_t values;
+  gc_canned_t canned;
 } parser_block_t;
 
+// Pre-parsed g-code word, see gc_tokenize_line(). Packed, as blocks of words are stored.
+typedef struct __attribute__((packed)) {
+  char letter;
+  float value;
+} gc_word_t;
+#ifdef PARAMETRIC_GCODE
+  // Pre-parsed blocks also hold compiled values, each stored as [code length][code]:
+  //   [letter | GC_WORD_EXPRESSION][value]     word of a computed value
+  //   ['#'][number][value]                     parameter setting
+  #define GC_WORD_EXPRESSION bit(7)
+  #define GC_MAX_PARAMETER_SETTINGS 8   // Parameter settings within a block
+#endif
+
 /* Exported variables --------------------------------------------------------*/
 /* Exported function ---------------------------------------------------------*/
 extern void gc_init(void);
 extern uint8_t gc_execute_line(char *line);
+extern uint8_t gc_execute_words(const uint8_t *block, uint8_t length);
+extern uint8_t gc_tokenize_line(char *line, uint8_t *block, uint8_t max_length, uint8_t *length);
 extern void gc_sync_position(void);
 
 
@@ -0,0 +1,467 @@
+/**
+  ******************************************************************************
+  * @file    oword.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   O-word subroutines and loops. Bodies are stored as pre-parsed word blocks in a RAM
+             cache and replayed through gc_execute_words().
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "oword.h"
+#include "system.h"
+#include "gcode.h"
+#include "report.h"
+#include "protocol.h"
+#include "serial.h"
+
+#ifdef OWORD_SUBROUTINES
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint8_t length;
+    uint8_t data[OWORD_ARGUMENT_SIZE];
+} oword_argument_t;
+
+typedef struct {
+    uint16_t number;
+    uint16_t start;           // Body records in the cache, from start up to end
+    uint16_t end;
+} oword_sub_t;
+
+/* Private define ------------------------------------------------------------*/
+#define OWORD_NONE            0
+#define OWORD_SUB             1
+#define OWORD_ENDSUB          2
+#define OWORD_CALL            3
+#define OWORD_REPEAT          4
+#define OWORD_ENDREPEAT       5
+#define OWORD_WHILE           6
+#define OWORD_ENDWHILE        7
+#define OWORD_KEYWORDS        8
+
+#define OWORD_KEYWORD_LENGTH  9     // Longest keyword, ENDREPEAT
+#define OWORD_NUMBER_MAX      65535
+
+/* Cache records, the first byte tells the type:
+     block:    [length][block pre-parsed by gc_tokenize_line(), length bytes]
+     control:  [keyword | OWORD_RECORD_CONTROL][number, uint16][argument length][argument]
+   The loop argument is its compiled expression with PARAMETRIC_GCODE, its float value otherwise. */
+#define OWORD_RECORD_CONTROL  0xF0
+#define OWORD_BLOCK_MAX_LENGTH  (OWORD_RECORD_CONTROL - 1)
+#define OWORD_CONTROL_LENGTH  (1 + sizeof(uint16_t) + 1)  // Without the argument
+
+/* Private macro -------------------------------------------------------------*/
+#define OWORD_IS_LOOP(keyword)  (((keyword) == OWORD_REPEAT) || ((keyword) == OWORD_WHILE))
+#define OWORD_IS_CONTROL(header)  (((header) & OWORD_RECORD_CONTROL) == OWORD_RECORD_CONTROL)
+
+/* Private variables ---------------------------------------------------------*/
+static const char oword_keywords[OWORD_KEYWORDS][OWORD_KEYWORD_LENGTH + 1] = {
+    "", "SUB", "ENDSUB", "CALL", "REPEAT", "ENDREPEAT", "WHILE", "ENDWHILE"
+};
+
+static uint8_t cache[OWORD_CACHE_SIZE];
+static uint16_t cache_end;              // End of the stored subroutines, bodies are recorded after it
+static oword_sub_t subs[OWORD_MAX_SUBS];
+static uint8_t sub_count;
+
+/* Body being recorded */
+static uint8_t record_keyword;          // OWORD_SUB, OWORD_REPEAT or OWORD_WHILE, OWORD_NONE if none
+static uint16_t record_number;
+static uint16_t record_end;             // Next record position
+static uint8_t record_depth;            // Loops opened within the body
+static uint8_t record_status;           // First error within the body, reported again upon its end
+
+/* Private function prototypes -----------------------------------------------*/
+static uint8_t _run(uint16_t start, uint16_t end, uint8_t nesting);
+
+/* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Parses an O-word line, after the 'O' letter.
+  * @param  char *line, uint8_t char_counter, at the number, uint8_t *keyword, uint16_t *number,
+            oword_argument_t *argument, the bracketed value, empty if none
+  * @retval uint8_t STATUS_OK, STATUS_OWORD_INVALID or the status code of an invalid expression
+  */
+static uint8_t _parse_line(char *line, uint8_t char_counter, uint8_t *keyword, uint16_t *number, oword_argument_t *argument) {
+    char name[OWORD_KEYWORD_LENGTH + 1];
+    uint8_t length = 0;
+    float value;
+    /* */
+    if (!read_float(line, &char_counter, &value)) { return(STATUS_OWORD_INVALID); }
+    if ((value < 0.0f) || (value > OWORD_NUMBER_MAX) || (value != (uint16_t)value)) { return(STATUS_OWORD_INVALID); }
+    *number = (uint16_t)value;
+    /* */
+    while ((line[char_counter] >= 'A') && (line[char_counter] <= 'Z')) {
+        if (length == OWORD_KEYWORD_LENGTH) { return(STATUS_OWORD_INVALID); }
+        name[length++] = line[char_counter++];
+    }
+    name[length] = 0;
+    *keyword = OWORD_NONE;
+    for (uint8_t idx = 1; idx < OWORD_KEYWORDS; idx++) {
+        if (strcmp(name, oword_keywords[idx]) == 0) { *keyword = idx; }
+    }
+    if (*keyword == OWORD_NONE) { return(STATUS_OWORD_INVALID); }
+    /* Loops take one bracketed value, the other keywords none */
+    argument->length = 0;
+    if (OWORD_IS_LOOP(*keyword)) {
+        if (line[char_counter] != '[') { return(STATUS_OWORD_INVALID); }
+        #ifdef PARAMETRIC_GCODE
+          uint8_t status = expr_compile(line, &char_counter, argument->data, OWORD_ARGUMENT_SIZE, &argument->length);
+          if (status != STATUS_OK) { return(status); }
+        #else
+          char_counter++;
+          if (!read_float(line, &char_counter, &value)) { return(STATUS_OWORD_INVALID); }
+          if (line[char_counter++] != ']') { return(STATUS_OWORD_INVALID); }
+          memcpy(argument->data, &value, sizeof(float));
+          argument->length = sizeof(float);
+        #endif
+    }
+    if (line[char_counter] != 0) { return(STATUS_OWORD_INVALID); }
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Looks up a defined subroutine.
+  * @param  uint16_t number
+  * @retval oword_sub_t *, NULL if not defined
+  */
+static oword_sub_t *_find_sub(uint16_t number) {
+    for (uint8_t idx = 0; idx < sub_count; idx++) {
+        if (subs[idx].number == number) { return(&subs[idx]); }
+    }
+    return(NULL);
+}
+
+/**
+  * @brief  Removes a subroutine and moves the following bodies down over its body.
+  * @param  oword_sub_t *sub
+  * @retval None
+  */
+static void _remove_sub(oword_sub_t *sub) {
+    uint16_t start = sub->start;
+    uint16_t length = sub->end - sub->start;
+    /* */
+    memmove(&cache[start], &cache[sub->end], cache_end - sub->end);
+    cache_end -= length;
+    *sub = subs[--sub_count];
+    for (uint8_t idx = 0; idx < sub_count; idx++) {
+        if (subs[idx].start > start) {
+            subs[idx].start -= length;
+            subs[idx].end -= length;
+        }
+    }
+}
+
+/**
+  * @brief  Appends a control record to the body being recorded.
+  * @param  uint8_t keyword, uint16_t number, const oword_argument_t *argument
+  * @retval uint8_t STATUS_OK or STATUS_OWORD_CACHE_FULL
+  */
+static uint8_t _record_control(uint8_t keyword, uint16_t number, const oword_argument_t *argument) {
+    if ((record_end + OWORD_CONTROL_LENGTH + argument->length) > OWORD_CACHE_SIZE) { return(STATUS_OWORD_CACHE_FULL); }
+    cache[record_end] = keyword | OWORD_RECORD_CONTROL;
+    memcpy(&cache[record_end + 1], &number, sizeof(uint16_t));
+    cache[record_end + 1 + sizeof(uint16_t)] = argument->length;
+    memcpy(&cache[record_end + OWORD_CONTROL_LENGTH], argument->data, argument->length);
+    record_end += OWORD_CONTROL_LENGTH + argument->length;
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Appends a g-code line to the body being recorded, as a block of pre-parsed words.
+  * @param  char *line
+  * @retval uint8_t status code of the word syntax, or STATUS_OWORD_CACHE_FULL
+  */
+static uint8_t _record_block(char *line) {
+    uint8_t length;
+    uint16_t space = OWORD_CACHE_SIZE - record_end;
+    uint8_t max_length = 0;
+    /* */
+    if (space > 1) {
+        max_length = min(space - 1, OWORD_BLOCK_MAX_LENGTH);
+    }
+    uint8_t status = gc_tokenize_line(line, &cache[record_end + 1], max_length, &length);
+    if (status == STATUS_OVERFLOW) { return(STATUS_OWORD_CACHE_FULL); }
+    if (status != STATUS_OK) { return(status); }
+    cache[record_end] = length;
+    record_end += 1 + length;
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Ends the body being recorded: stores the subroutine or runs the loop.
+  * @param  None
+  * @retval uint8_t status code
+  */
+static uint8_t _record_finish(void) {
+    uint8_t keyword = record_keyword;
+    record_keyword = OWORD_NONE;
+    if (record_status != STATUS_OK) { return(record_status); }
+    /* */
+    if (keyword == OWORD_SUB) {
+        // A redefined subroutine is removed only now its new body is complete, which moves the
+        // new body down along with the stored ones.
+        uint16_t length = record_end - cache_end;
+        oword_sub_t *sub = _find_sub(record_number);
+        cache_end = record_end;
+        if (sub != NULL) { _remove_sub(sub); }
+        subs[sub_count].number = record_number;
+        subs[sub_count].start = cache_end - length;
+        subs[sub_count].end = cache_end;
+        sub_count++;
+        return(STATUS_OK);
+    }
+    // Loop from the stream, stored with its control records after the subroutines.
+    return(_run(cache_end, record_end, 0));
+}
+
+/**
+  * @brief  Takes one line while a body is recorded.
+  * @param  char *line, uint8_t is_oword, uint8_t char_counter, at the O-word number
+  * @retval uint8_t status code
+  */
+static uint8_t _record_line(char *line, uint8_t is_oword, uint8_t char_counter) {
+    uint8_t status;
+    uint8_t keyword;
+    uint16_t number;
+    oword_argument_t argument;
+    /* */
+    if (!is_oword) {
+        status = _record_block(line);
+    } else {
+        status = _parse_line(line, char_counter, &keyword, &number, &argument);
+        if (status == STATUS_OK) {
+            // End of the recorded body
+            if (record_depth == 0) {
+                if ((keyword == OWORD_ENDSUB) && (record_keyword == OWORD_SUB) && (number == record_number)) {
+                    return(_record_finish());
+                }
+                if ((keyword == (record_keyword + 1)) && OWORD_IS_LOOP(record_keyword) && (number == record_number)) {
+                    status = _record_control(keyword, number, &argument);
+                    if (status != STATUS_OK) {
+                        record_keyword = OWORD_NONE;
+                        return(status);
+                    }
+                    return(_record_finish());
+                }
+            }
+            // Calls and loops within the body. Subroutines are not defined within others.
+            if ((keyword == OWORD_SUB) || (keyword == OWORD_ENDSUB)) {
+                status = STATUS_OWORD_INVALID;
+            } else if (OWORD_IS_LOOP(keyword)) {
+                record_depth++;
+            } else if (keyword != OWORD_CALL) {
+                if (record_depth == 0) { status = STATUS_OWORD_INVALID; }
+                else { record_depth--; }
+            }
+            if (status == STATUS_OK) { status = _record_control(keyword, number, &argument); }
+        }
+    }
+    if ((status != STATUS_OK) && (record_status == STATUS_OK)) {
+        record_status = status;
+    }
+    return(status);
+}
+
+/**
+  * @brief  Gives the size of a cache record.
+  * @param  uint16_t pos
+  * @retval uint16_t bytes of the record
+  */
+static uint16_t _record_size(uint16_t pos) {
+    if (OWORD_IS_CONTROL(cache[pos])) { return(OWORD_CONTROL_LENGTH + cache[pos + 1 + sizeof(uint16_t)]); }
+    return(1 + cache[pos]);
+}
+
+/**
+  * @brief  Gives the loop argument of a control record, evaluated with the current parameters.
+  * @param  uint16_t pos, float *value
+  * @retval uint8_t STATUS_OK or the status code of the failing expression
+  */
+static uint8_t _argument_value(uint16_t pos, float *value) {
+    const uint8_t *argument = &cache[pos + OWORD_CONTROL_LENGTH];
+    #ifdef PARAMETRIC_GCODE
+      return(expr_evaluate(argument, cache[pos + 1 + sizeof(uint16_t)], value));
+    #else
+      memcpy(value, argument, sizeof(float));
+      return(STATUS_OK);
+    #endif
+}
+
+/**
+  * @brief  Finds the end record of a loop.
+  * @param  uint16_t pos, first record of the body, uint16_t end, uint8_t keyword, uint16_t number
+  * @retval uint16_t position of the end record, end if missing
+  */
+static uint16_t _find_loop_end(uint16_t pos, uint16_t end, uint8_t keyword, uint16_t number) {
+    while (pos < end) {
+        uint8_t header = cache[pos];
+        if (OWORD_IS_CONTROL(header)) {
+            uint16_t record_number;
+            memcpy(&record_number, &cache[pos + 1], sizeof(uint16_t));
+            if (((header & ~OWORD_RECORD_CONTROL) == keyword) && (record_number == number)) { return(pos); }
+        }
+        pos += _record_size(pos);
+    }
+    return(end);
+}
+
+/**
+  * @brief  Runs the records of a body. Blocks go to the g-code parser, calls and loops run their
+            bodies with one more nesting level.
+  * @param  uint16_t start, uint16_t end, uint8_t nesting
+  * @retval uint8_t status code of the first failing block, STATUS_OK upon system abort
+  */
+static uint8_t _run(uint16_t start, uint16_t end, uint8_t nesting) {
+    uint16_t pos = start;
+    uint8_t status;
+    /* */
+    while (pos < end) {
+        protocol_execute_realtime(); // Runtime command check point.
+        if (sys.abort) { return(STATUS_OK); }
+        uint8_t header = cache[pos];
+        if (!OWORD_IS_CONTROL(header)) {
+            status = gc_execute_words(&cache[pos + 1], header);
+            if (status != STATUS_OK) { return(status); }
+            pos += 1 + header;
+            continue;
+        }
+        /* */
+        uint8_t keyword = header & ~OWORD_RECORD_CONTROL;
+        uint16_t control = pos;
+        uint16_t number;
+        float argument;
+        memcpy(&number, &cache[pos + 1], sizeof(uint16_t));
+        pos += _record_size(pos);
+        if ((keyword == OWORD_CALL) || OWORD_IS_LOOP(keyword)) {
+            if (nesting == OWORD_MAX_NESTING) { return(STATUS_OWORD_INVALID); }
+        }
+        /* */
+        if (keyword == OWORD_CALL) {
+            oword_sub_t *sub = _find_sub(number);
+            if (sub == NULL) { return(STATUS_OWORD_UNDEFINED); }
+            status = _run(sub->start, sub->end, nesting + 1);
+            if (status != STATUS_OK) { return(status); }
+        }
+        else if (OWORD_IS_LOOP(keyword)) {
+            uint16_t body_end = _find_loop_end(pos, end, keyword + 1, number);
+            if (body_end == end) { return(STATUS_OWORD_INVALID); }
+            // The repeat count is evaluated once, the while condition before each run of the body
+            status = _argument_value(control, &argument);
+            if (status != STATUS_OK) { return(status); }
+            if (keyword == OWORD_REPEAT) {
+                uint32_t count = 0;
+                if (argument >= (float)UINT32_MAX) { count = UINT32_MAX; }
+                else if (argument >= 1.0f) { count = (uint32_t)argument; }
+                for (; count != 0; count--) {
+                    protocol_execute_realtime(); // Runtime command check point, also for an empty body.
+                    if (sys.abort) { return(STATUS_OK); }
+                    status = _run(pos, body_end, nesting + 1);
+                    if (status != STATUS_OK) { return(status); }
+                }
+            }
+            else {
+                while (argument != 0.0f) {
+                    protocol_execute_realtime(); // Runtime command check point, also for an empty body.
+                    if (sys.abort) { return(STATUS_OK); }
+                    status = _run(pos, body_end, nesting + 1);
+                    if (status != STATUS_OK) { return(status); }
+                    status = _argument_value(control, &argument);
+                    if (status != STATUS_OK) { return(status); }
+                }
+            }
+            pos = body_end + _record_size(body_end);
+        }
+    }
+    return(STATUS_OK);
+}
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  Drops a partially received subroutine or loop. Called upon system reset. Defined
+            subroutines are kept.
+  * @param  None
+  * @retval None
+  */
+void oword_reset(void) {
+    record_keyword = OWORD_NONE;
+}
+
+/**
+  * @brief  Takes O-word lines, and all g-code lines of the main channel while a subroutine or loop
+            body is received. O-word lines of the other channels are refused.
+  * @param  char *line, uint8_t *status, set to the status code of a taken line
+  * @retval true if the line was taken, false to execute it as g-code
+  */
+uint8_t oword_execute_line(char *line, uint8_t *status) {
+    uint8_t char_counter = 0;
+    float value;
+    uint8_t keyword;
+    uint16_t number;
+    oword_argument_t argument;
+    /* A line number is allowed and ignored before the O-word */
+    if (line[0] == 'N') {
+        char_counter = 1;
+        if (!read_float(line, &char_counter, &value)) { char_counter = 0; }
+    }
+    uint8_t is_oword = (line[char_counter] == 'O');
+    if (is_oword) { char_counter++; }
+    /* Subroutines and loops belong to the program stream, the other channels may not use them */
+    if (serial_get_channel() != SERIAL_CHANNEL_MAIN) {
+        if (is_oword) { *status = STATUS_OWORD_INVALID; }
+        return(is_oword);
+    }
+    if (record_keyword != OWORD_NONE) {
+        *status = _record_line(line, is_oword, char_counter);
+        return(true);
+    }
+    if (!is_oword) { return(false); }
+    /* */
+    *status = _parse_line(line, char_counter, &keyword, &number, &argument);
+    if (*status != STATUS_OK) { return(true); }
+    switch (keyword) {
+        case OWORD_SUB:
+            // A subroutine being redefined is kept until its new body is complete.
+            record_keyword = OWORD_SUB;
+            record_end = cache_end;
+            record_status = STATUS_OK;
+            if ((sub_count == OWORD_MAX_SUBS) && (_find_sub(number) == NULL)) { record_status = STATUS_OWORD_CACHE_FULL; }
+        break;
+        /* */
+        case OWORD_CALL:
+            {
+                oword_sub_t *sub = _find_sub(number);
+                if (sub == NULL) { *status = STATUS_OWORD_UNDEFINED; }
+                else { *status = _run(sub->start, sub->end, 1); }
+            }
+        break;
+        /* */
+        case OWORD_REPEAT:
+        case OWORD_WHILE:
+            record_keyword = keyword;
+            record_end = cache_end;
+            record_status = _record_control(keyword, number, &argument);
+        break;
+        /* */
+        default:
+            *status = STATUS_OWORD_INVALID; // End without its start
+        break;
+    }
+    if (record_keyword != OWORD_NONE) {
+        record_number = number;
+        record_depth = 0;
+    }
+    return(true);
+}
+
+#endif  /* OWORD_SUBROUTINES */
+
+/******************************************************************************
+      END FILE
+******************************************************************************/
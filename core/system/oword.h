@@ -0,0 +1,58 @@
+/**
+  ******************************************************************************
+  * @file    oword.h
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   O-word subroutines and loops, run from a RAM cache of pre-parsed blocks.
+  ******************************************************************************
+**/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GRBL_OWORD_H
+#define __GRBL_OWORD_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "nuts_bolts.h"
+#ifdef PARAMETRIC_GCODE
+  #include "expression.h"
+#endif
+
+/* Exported define -----------------------------------------------------------*/
+/* O-word lines, the number is an integer from 0 to 65535:
+     O<n> SUB ... O<n> ENDSUB               define subroutine n, replacing a previous one
+     O<n> CALL                              run subroutine n
+     O<n> REPEAT [count] ... O<n> ENDREPEAT run the body count times
+     O<n> WHILE [value] ... O<n> ENDWHILE   run the body while the value is not zero
+   With PARAMETRIC_GCODE, the count and value are expressions, a WHILE value is evaluated before
+   each run of the body.
+   Lines of a subroutine or loop body are stored as blocks of pre-parsed words, so a body runs
+   without receiving or parsing its text again. Loops sent in the stream are stored up to their end
+   line, then run. Subroutines stay in the cache until redefined or power down. */
+#ifndef OWORD_CACHE_SIZE
+  #define OWORD_CACHE_SIZE        2048  // Bytes of stored subroutine and loop bodies
+#endif
+#ifndef OWORD_MAX_SUBS
+  #define OWORD_MAX_SUBS          16    // Subroutines defined at a time
+#endif
+#define OWORD_MAX_NESTING         8     // Calls and loops running within each other
+#ifdef PARAMETRIC_GCODE
+  #define OWORD_ARGUMENT_SIZE     EXPR_CODE_SIZE  // Bytes of a compiled loop argument
+#else
+  #define OWORD_ARGUMENT_SIZE     sizeof(float)
+#endif
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported typedef ----------------------------------------------------------*/
+/* Exported variables --------------------------------------------------------*/
+/* Exported function ---------------------------------------------------------*/
+extern void oword_reset(void);
+extern uint8_t oword_execute_line(char *line, uint8_t *status);
+
+
+#endif /* __GRBL_OWORD_H */
+/******************************************************************************
+      END FILE
+******************************************************************************/
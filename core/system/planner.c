@@ -99,6 +99,7 @@ static planner_t pl;
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static plan_block_t block_buffer[BLOCK_BUFFER_SIZE];  // A ring buffer for motion instructions
+static plan_block_speed_t block_speed[BLOCK_BUFFER_SIZE];  // Planning data, indexed as block_buffer
 static uint8_t block_buffer_tail;     // Index of the block to process now
 static uint8_t block_buffer_head;     // Index of the next block to be pushed
 static uint8_t next_buffer_head;      // Index of the next buffer head
@@ -135,8 +136,8 @@ static void planner_recalculate(void) {
     // block in buffer. Cease planning when the last optimal planned or tail pointer is reached.
     // NOTE: Forward pass will later refine and correct the reverse pass to create an optimal plan.
     float entry_speed_sqr;
-    plan_block_t *next;
-    plan_block_t *current = &block_buffer[block_index];
+    plan_block_speed_t *next;
+    plan_block_speed_t *current = &block_speed[block_index];
 
     // Calculate maximum entry speed for last block in buffer, where the exit speed is always zero.
     current->entry_speed_sqr = min( current->max_entry_speed_sqr, 2*current->acceleration*current->millimeters);
@@ -148,7 +149,7 @@ static void planner_recalculate(void) {
     } else { // Three or more plan-able blocks
       while (block_index != block_buffer_planned) {
         next = current;
-        current = &block_buffer[block_index];
+        current = &block_speed[block_index];
         block_index = plan_prev_block_index(block_index);
 
         // Check if next block is the tail block(=planned block). If so, update current stepper parameters.
@@ -168,11 +169,11 @@ static void planner_recalculate(void) {
 
     // Forward Pass: Forward plan the acceleration curve from the planned pointer onward.
     // Also scans for optimal plan breakpoints and appropriately updates the planned pointer.
-    next = &block_buffer[block_buffer_planned]; // Begin at buffer planned pointer
+    next = &block_speed[block_buffer_planned]; // Begin at buffer planned pointer
     block_index = plan_next_block_index(block_buffer_planned);
     while (block_index != block_buffer_head) {
       current = next;
-      next = &block_buffer[block_index];
+      next = &block_speed[block_index];
 
       // Any acceleration detected in the forward pass automatically moves the optimal planned
       // pointer forward, since everything before this is all optimal. In other words, nothing
@@ -198,16 +199,59 @@ static void planner_recalculate(void) {
 /**
   * @brief  Computes and updates the max entry speed (sqr) of the block, based on the minimum of the junction's
             previous and current nominal speeds and max junction speed.
-  * @param  plan_block_t *block, float nominal_speed, float prev_nominal_spee
+  * @param  uint8_t block_index, float nominal_speed, float prev_nominal_speed
   * @retval None
   */
-static void plan_compute_profile_parameters(plan_block_t *block, float nominal_speed, float prev_nominal_speed) {
+static void plan_compute_profile_parameters(uint8_t block_index, float nominal_speed, float prev_nominal_speed) {
+    plan_block_speed_t *speed = &block_speed[block_index];
+    float max_junction_speed_sqr = block_buffer[block_index].max_junction_speed_sqr;
     /* compute the junction maximum entry based on the minimum of the junction speed and neighboring nominal speeds */
-    if (nominal_speed > prev_nominal_speed) { block->max_entry_speed_sqr = prev_nominal_speed*prev_nominal_speed; }
-    else { block->max_entry_speed_sqr = nominal_speed*nominal_speed; }
-    if (block->max_entry_speed_sqr > block->max_junction_speed_sqr) { block->max_entry_speed_sqr = block->max_junction_speed_sqr; }
+    if (nominal_speed > prev_nominal_speed) { speed->max_entry_speed_sqr = prev_nominal_speed*prev_nominal_speed; }
+    else { speed->max_entry_speed_sqr = nominal_speed*nominal_speed; }
+    if (speed->max_entry_speed_sqr > max_junction_speed_sqr) { speed->max_entry_speed_sqr = max_junction_speed_sqr; }
 }
 
+/**
+  * @brief  Computes the block acceleration and rapid rate limited by the axis maximums along the line
+            direction. Both limits share one reciprocal per axis instead of two separate divide loops.
+  * @param  plan_block_t *block, plan_block_speed_t *speed, float *unit_vec
+  * @retval None
+  */
+static void plan_limit_by_axis_maximums(plan_block_t *block, plan_block_speed_t *speed, float *unit_vec) {
+    float acceleration = SOME_LARGE_VALUE;
+    float rapid_rate = SOME_LARGE_VALUE;
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        if (unit_vec[idx] != 0.0f) {
+            float inv_unit = fabsf(1.0f/unit_vec[idx]);
+            acceleration = min(acceleration, settings.acceleration[idx]*inv_unit);
+            rapid_rate = min(rapid_rate, settings.max_rate[idx]*inv_unit);
+        }
+    }
+    speed->acceleration = acceleration;
+    block->rapid_rate = rapid_rate;
+}
+
+#ifdef JUNCTION_JERK_MODEL
+/**
+  * @brief  Computes the max junction speed (sqr) from the per-axis velocity change limits. Passing the
+            junction at speed v changes the velocity of each axis by v*|unit_vec - previous_unit_vec|,
+            so the junction speed is the largest v that keeps every axis within its settings.max_jerk.
+  * @param  float *unit_vec
+  * @retval float max junction speed in (mm/min)^2
+  */
+static float plan_compute_junction_speed_sqr_by_jerk(float *unit_vec) {
+    float junction_speed_sqr = SOME_LARGE_VALUE;
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        float delta_unit = unit_vec[idx] - pl.previous_unit_vec[idx];
+        float delta_unit_sqr = delta_unit*delta_unit;
+        if (delta_unit_sqr > 0.0f) {
+            junction_speed_sqr = min(junction_speed_sqr, (settings.max_jerk[idx]*settings.max_jerk[idx])/delta_unit_sqr);
+        }
+    }
+    return max(MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED, junction_speed_sqr);
+}
+#endif
+
 /* Exported Functions --------------------------------------------------------*/
 
 /**
@@ -280,6 +324,15 @@ plan_block_t *plan_get_current_block(void) {
     return &block_buffer[block_buffer_tail];
 }
 
+/**
+  * @brief  Returns address of the planning data of a block from the planner buffer.
+  * @param  plan_block_t *block
+  * @retval plan_block_speed_t pointer
+  */
+plan_block_speed_t *plan_get_block_speed(plan_block_t *block) {
+    return &block_speed[block - block_buffer];
+}
+
 /**
   * @brief  plan_get_exec_block_exit_speed_sqr
   * @param  None
@@ -288,7 +341,7 @@ plan_block_t *plan_get_current_block(void) {
 float plan_get_exec_block_exit_speed_sqr(void) {
     uint8_t block_index = plan_next_block_index(block_buffer_tail);
     if (block_index == block_buffer_head) { return( 0.0 ); }
-    return( block_buffer[block_index].entry_speed_sqr );
+    return( block_speed[block_index].entry_speed_sqr );
 }
 
 /**
@@ -328,14 +381,12 @@ float plan_compute_profile_nominal_speed(plan_block_t *block) {
   */
 void plan_update_velocity_profile_parameters(void) {
     uint8_t block_index = block_buffer_tail;
-    plan_block_t *block;
     float nominal_speed;
     /* set high for first block nominal speed calculation */
     float prev_nominal_speed = SOME_LARGE_VALUE;
     while (block_index != block_buffer_head) {
-        block = &block_buffer[block_index];
-        nominal_speed = plan_compute_profile_nominal_speed(block);
-        plan_compute_profile_parameters(block, nominal_speed, prev_nominal_speed);
+        nominal_speed = plan_compute_profile_nominal_speed(&block_buffer[block_index]);
+        plan_compute_profile_parameters(block_index, nominal_speed, prev_nominal_speed);
         prev_nominal_speed = nominal_speed;
         block_index = plan_next_block_index(block_index);
     }
@@ -364,7 +415,9 @@ void plan_update_velocity_profile_parameters(void) {
 uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data) {
   /* prepare and initialize new block, copy relevant pl_data for block execution */
   plan_block_t *block = &block_buffer[block_buffer_head];
+  plan_block_speed_t *speed = &block_speed[block_buffer_head];
   memset(block,0,sizeof(plan_block_t)); // Zero all block values.
+  memset(speed,0,sizeof(plan_block_speed_t));
   block->condition = pl_data->condition;
   #ifdef VARIABLE_SPINDLE
     block->spindle_speed = pl_data->spindle_speed;
@@ -432,15 +485,20 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data) {
   // down such that no individual axes maximum values are exceeded with respect to the line direction.
   // NOTE: This calculation assumes all axes are orthogonal (Cartesian) and works with ABC-axes,
   // if they are also orthogonal/independent. Operates on the absolute value of the unit vector.
-  block->millimeters = convert_delta_vector_to_unit_vector(unit_vec);
-  block->acceleration = limit_value_by_axis_maximum(settings.acceleration, unit_vec);
-  block->rapid_rate = limit_value_by_axis_maximum(settings.max_rate, unit_vec);
+  // NOTE: The inverse length is computed once and shared by the normalization and both axis limits,
+  // so no sqrt or per-axis divide is repeated for the same vector.
+  float length_sqr = 0.0f;
+  for (idx=0; idx<N_AXIS; idx++) { length_sqr += unit_vec[idx]*unit_vec[idx]; }
+  float inv_millimeters = inv_sqrt_f(length_sqr);
+  speed->millimeters = length_sqr*inv_millimeters;
+  for (idx=0; idx<N_AXIS; idx++) { unit_vec[idx] *= inv_millimeters; }
+  plan_limit_by_axis_maximums(block, speed, unit_vec);
 
   // Store programmed rate.
   if (block->condition & PL_COND_FLAG_RAPID_MOTION) { block->programmed_rate = block->rapid_rate; }
   else {
     block->programmed_rate = pl_data->feed_rate;
-    if (block->condition & PL_COND_FLAG_INVERSE_TIME) { block->programmed_rate *= block->millimeters; }
+    if (block->condition & PL_COND_FLAG_INVERSE_TIME) { block->programmed_rate *= speed->millimeters; }
   }
 
   // TODO: Need to check this method handling zero junction speeds when starting from rest.
@@ -448,10 +506,13 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data) {
 
     // Initialize block entry speed as zero. Assume it will be starting from rest. Planner will correct this later.
     // If system motion, the system motion block always is assumed to start from rest and end at a complete stop.
-    block->entry_speed_sqr = 0.0;
+    speed->entry_speed_sqr = 0.0;
     block->max_junction_speed_sqr = 0.0; // Starting from rest. Enforce start from zero velocity.
 
   } else {
+  #ifdef JUNCTION_JERK_MODEL
+    block->max_junction_speed_sqr = plan_compute_junction_speed_sqr_by_jerk(unit_vec);
+  #else
     // Compute maximum allowable entry speed at junction by centripetal acceleration approximation.
     // Let a circle be tangent to both previous and current path line segments, where the junction
     // deviation is defined as the distance from the junction to the closest edge of the circle,
@@ -474,35 +535,41 @@ uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data) {
     // memory in the event of a feedrate override changing the nominal speeds of blocks, which can
     // change the overall maximum entry speed conditions of all blocks.
 
-    float junction_unit_vec[N_AXIS];
-    float junction_cos_theta = 0.0;
+    float junction_cos_theta = 0.0f;
     for (idx=0; idx<N_AXIS; idx++) {
       junction_cos_theta -= pl.previous_unit_vec[idx]*unit_vec[idx];
-      junction_unit_vec[idx] = unit_vec[idx]-pl.previous_unit_vec[idx];
     }
 
     // NOTE: Computed without any expensive trig, sin() or acos(), by trig half angle identity of cos(theta).
-    if (junction_cos_theta > 0.999999) {
+    if (junction_cos_theta > 0.999999f) {
       //  For a 0 degree acute junction, just set minimum junction speed.
       block->max_junction_speed_sqr = MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED;
     } else {
-      if (junction_cos_theta < -0.999999) {
+      if (junction_cos_theta < -0.999999f) {
         // Junction is a straight line or 180 degrees. Junction speed is infinite.
         block->max_junction_speed_sqr = SOME_LARGE_VALUE;
       } else {
-        convert_delta_vector_to_unit_vector(junction_unit_vec);
+        // Both path vectors are unit length, so |unit_vec - previous_unit_vec|^2 = 2*(1 + cos_theta).
+        // The junction vector is normalized from the cosine already at hand, no second length pass.
+        float junction_unit_vec[N_AXIS];
+        float inv_junction_length = inv_sqrt_f(2.0f*(1.0f + junction_cos_theta));
+        for (idx=0; idx<N_AXIS; idx++) {
+          junction_unit_vec[idx] = (unit_vec[idx]-pl.previous_unit_vec[idx])*inv_junction_length;
+        }
         float junction_acceleration = limit_value_by_axis_maximum(settings.acceleration, junction_unit_vec);
-        float sin_theta_d2 = sqrt(0.5*(1.0-junction_cos_theta)); // Trig half angle identity. Always positive.
+        float sin_theta_d2_sqr = 0.5f*(1.0f-junction_cos_theta);
+        float sin_theta_d2 = sin_theta_d2_sqr*inv_sqrt_f(sin_theta_d2_sqr); // Trig half angle identity. Always positive.
         block->max_junction_speed_sqr = max( MINIMUM_JUNCTION_SPEED*MINIMUM_JUNCTION_SPEED,
-                       (junction_acceleration * settings.junction_deviation * sin_theta_d2)/(1.0-sin_theta_d2) );
+                       (junction_acceleration * settings.junction_deviation * sin_theta_d2)/(1.0f-sin_theta_d2) );
       }
     }
+  #endif
   }
 
   // Block system motion from updating this data to ensure next g-code motion is computed correctly.
   if (!(block->condition & PL_COND_FLAG_SYSTEM_MOTION)) {
     float nominal_speed = plan_compute_profile_nominal_speed(block);
-    plan_compute_profile_parameters(block, nominal_speed, pl.previous_nominal_speed);
+    plan_compute_profile_parameters(block_buffer_head, nominal_speed, pl.previous_nominal_speed);
     pl.previous_nominal_speed = nominal_speed;
 
     // Update previous path unit_vector and planner position.
@@ -545,6 +612,18 @@ void plan_sync_position(void) {
     }
 }
 
+/**
+  * @brief  Returns the planner position in machine coordinates (mm). This is the end point of the last
+            queued motion, not the current machine position.
+  * @param  float *target
+  * @retval None
+  */
+void plan_get_planner_mpos(float *target) {
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        target[idx] = pl.position[idx] / settings.steps_per_mm[idx];
+    }
+}
+
 /**
   * @brief  Returns the number of available blocks are in the planner buffer
   * @param  None
@@ -62,16 +62,8 @@ typedef struct {
       int32_t line_number;  // Block line number for real-time reporting. Copied from pl_line_data.
     #endif
 
-    // Fields used by the motion planner to manage acceleration. Some of these values may be updated
-    // by the stepper module during execution of special motion cases for replanning purposes.
-    float entry_speed_sqr;     // The current planned entry speed at block junction in (mm/min)^2
-    float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
-                               //   neighboring nominal speeds with overrides in (mm/min)^2
-    float acceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
-    float millimeters;         // The remaining distance for this block to be executed in (mm).
-                               // NOTE: This value may be altered by stepper algorithm during execution.
-
     // Stored rate limiting data used by planner when changes occur.
+    // NOTE: The speed fields used by the planner passes live in plan_block_speed_t.
     float max_junction_speed_sqr; // Junction entry speed limit based on direction vectors in (mm/min)^2
     float rapid_rate;             // Axis-limit adjusted maximum rate for this block direction in (mm/min)
     float programmed_rate;        // Programmed rate of this block (mm/min).
@@ -83,6 +75,21 @@ typedef struct {
 } plan_block_t;
 
 
+// Planning data of a block. Kept apart from plan_block_t, in an array indexed in parallel with the
+// block buffer, since the reverse and forward passes of the planner only touch these fields and can
+// then stream through one small packed array instead of striding over the Bresenham data.
+// Some of these values may be updated by the stepper module during execution of special motion cases
+// for replanning purposes.
+typedef struct {
+    float entry_speed_sqr;     // The current planned entry speed at block junction in (mm/min)^2
+    float max_entry_speed_sqr; // Maximum allowable entry speed based on the minimum of junction limit and
+                               //   neighboring nominal speeds with overrides in (mm/min)^2
+    float acceleration;        // Axis-limit adjusted line acceleration in (mm/min^2). Does not change.
+    float millimeters;         // The remaining distance for this block to be executed in (mm).
+                               // NOTE: This value may be altered by stepper algorithm during execution.
+} plan_block_speed_t;
+
+
 // Planner data prototype. Must be used when passing new motions to the planner.
 typedef struct {
     float feed_rate;          // Desired feed rate for line motion. Value is ignored, if rapid motion.
@@ -101,6 +108,7 @@ extern uint8_t plan_buffer_line(float *target, plan_line_data_t *pl_data);
 extern void plan_discard_current_block(void);
 extern plan_block_t *plan_get_system_motion_block(void);
 extern plan_block_t *plan_get_current_block(void);
+extern plan_block_speed_t *plan_get_block_speed(plan_block_t *block);
 extern uint8_t plan_next_block_index(uint8_t block_index);
 extern float plan_get_exec_block_exit_speed_sqr(void);
 extern float plan_compute_profile_nominal_speed(plan_block_t *block);
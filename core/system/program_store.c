@@ -0,0 +1,449 @@
+/**
+  ******************************************************************************
+  * @file    program_store.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Local program storage on the block storage HAL. Programs are received once from the
+             host and run locally, read block by block ahead of the line processing.
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "program_store.h"
+#include "system.h"
+#include "report.h"
+#include "protocol.h"
+
+#ifdef PROGRAM_STORE
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct {
+    uint32_t magic;
+    program_entry_t entries[PROGRAM_STORE_MAX_PROGRAMS];
+} program_directory_t;
+
+/* Private define ------------------------------------------------------------*/
+#define PROGRAM_STORE_BLOCKS(size)  (((size) + NGRBL_HAL_STORAGE_BLOCK_SIZE - 1)/NGRBL_HAL_STORAGE_BLOCK_SIZE)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static union {
+    program_directory_t directory;
+    uint8_t data[NGRBL_HAL_STORAGE_BLOCK_SIZE];
+} directory;
+static uint8_t directory_loaded;
+
+/* Data block buffers, one to receive a program or two to run one */
+static uint8_t buffer[2][NGRBL_HAL_STORAGE_BLOCK_SIZE];
+static volatile uint8_t read_pending;   // Block read started, until ngrbl_hal_storage_read_callback()
+static volatile uint8_t read_failed;    // The last block read completed with an error
+
+static struct {
+    uint8_t active;
+    uint8_t status;                     // First error within the program, reported again upon its end
+    char name[PROGRAM_NAME_LENGTH + 1];
+    uint32_t block;                     // First data block
+    uint32_t block_end;                 // End of the free blocks taken
+    uint32_t size;
+} receive;
+
+static struct {
+    uint8_t active;
+    uint8_t current;                    // Buffer being read, the other one is prefetched
+    uint16_t index;                     // Next character in the current buffer
+    uint32_t next_block;                // Next block to prefetch
+    uint32_t block_end;
+    uint32_t remaining;                 // Program bytes not read yet
+    uint8_t failed;                     // A block failed to read, the program ends there
+} reader;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Waits for the block read in progress. Keeps up with realtime commands meanwhile, so a
+            read that does not complete is left by a reset.
+  * @param  None
+  * @retval uint8_t STATUS_OK, STATUS_PROGRAM_STORAGE_FAIL upon a read error or system abort
+  */
+static uint8_t _wait_read(void) {
+    while (read_pending) {
+        protocol_execute_realtime(); // Runtime command check point.
+        if (sys.abort) { return(STATUS_PROGRAM_STORAGE_FAIL); }
+    }
+    return(read_failed ? STATUS_PROGRAM_STORAGE_FAIL : STATUS_OK);
+}
+
+/**
+  * @brief  Reads a block and waits for its completion.
+  * @param  uint32_t block, uint8_t *data
+  * @retval uint8_t STATUS_OK, STATUS_PROGRAM_STORAGE_FAIL upon a read error or system abort
+  */
+static uint8_t _read_block_wait(uint32_t block, uint8_t *data) {
+    _wait_read(); // Prefetch of an earlier run, its result is not used
+    if (sys.abort) { return(STATUS_PROGRAM_STORAGE_FAIL); }
+    read_failed = false;
+    read_pending = true;
+    ngrbl_hal_storage_read_block(block, data);
+    return(_wait_read());
+}
+
+/**
+  * @brief  Reads the directory upon first access. Storage without a valid directory is taken as
+            empty.
+  * @param  None
+  * @retval uint8_t STATUS_OK or STATUS_PROGRAM_STORAGE_FAIL without storage or upon a read error
+  */
+static uint8_t _load_directory(void) {
+    if (directory_loaded) { return(STATUS_OK); }
+    if (ngrbl_hal_storage_get_block_count() < 2) { return(STATUS_PROGRAM_STORAGE_FAIL); }
+    /* */
+    uint8_t status = _read_block_wait(0, directory.data);
+    if (status != STATUS_OK) { return(status); }
+    if (directory.directory.magic != PROGRAM_STORE_MAGIC) {
+        memset(directory.data, 0, sizeof(directory.data));
+        directory.directory.magic = PROGRAM_STORE_MAGIC;
+    }
+    directory_loaded = true;
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Writes the directory.
+  * @param  None
+  * @retval uint8_t STATUS_OK or STATUS_PROGRAM_STORAGE_FAIL
+  */
+static uint8_t _store_directory(void) {
+    if (!ngrbl_hal_storage_write_block(0, directory.data)) {
+        directory_loaded = false; // Read it again, the stored one is the valid one
+        return(STATUS_PROGRAM_STORAGE_FAIL);
+    }
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Checks a program name.
+  * @param  char *name
+  * @retval true if valid
+  */
+static uint8_t _check_name(char *name) {
+    uint8_t length = 0;
+    /* */
+    for (; name[length] != 0; length++) {
+        char c = name[length];
+        if (!(((c >= 'A') && (c <= 'Z')) || ((c >= '0') && (c <= '9')) ||
+              (c == '_') || (c == '-') || (c == '.'))) { return(false); }
+    }
+    return((length > 0) && (length <= PROGRAM_NAME_LENGTH));
+}
+
+/**
+  * @brief  Looks up a program in the directory.
+  * @param  char *name
+  * @retval program_entry_t *, NULL if not stored
+  */
+static program_entry_t *_find_program(char *name) {
+    for (uint8_t idx = 0; idx < PROGRAM_STORE_MAX_PROGRAMS; idx++) {
+        program_entry_t *entry = &directory.directory.entries[idx];
+        if ((entry->name[0] != 0) && (strcmp(entry->name, name) == 0)) { return(entry); }
+    }
+    return(NULL);
+}
+
+/**
+  * @brief  Finds the largest run of blocks not taken by a stored program.
+  * @param  uint32_t *block_start, uint32_t *block_end
+  * @retval None
+  */
+static void _find_free_blocks(uint32_t *block_start, uint32_t *block_end) {
+    uint32_t block_count = ngrbl_hal_storage_get_block_count();
+    /* */
+    *block_start = 1;
+    *block_end = 1;
+    // A free run starts after the directory or after a program, and ends at the next program.
+    for (int8_t candidate = -1; candidate < (int8_t)PROGRAM_STORE_MAX_PROGRAMS; candidate++) {
+        uint32_t start = 1;
+        if (candidate >= 0) {
+            program_entry_t *entry = &directory.directory.entries[candidate];
+            if (entry->name[0] == 0) { continue; }
+            start = entry->block + PROGRAM_STORE_BLOCKS(entry->size);
+        }
+        uint32_t end = block_count;
+        for (uint8_t idx = 0; idx < PROGRAM_STORE_MAX_PROGRAMS; idx++) {
+            program_entry_t *entry = &directory.directory.entries[idx];
+            if ((entry->name[0] == 0) || (entry->size == 0)) { continue; }
+            uint32_t entry_end = entry->block + PROGRAM_STORE_BLOCKS(entry->size);
+            if ((entry->block <= start) && (entry_end > start)) { end = start; } // Start is taken
+            else if ((entry->block > start) && (entry->block < end)) { end = entry->block; }
+        }
+        if ((end > start) && ((end - start) > (*block_end - *block_start))) {
+            *block_start = start;
+            *block_end = end;
+        }
+    }
+}
+
+/**
+  * @brief  Appends a character to the program being received, writing each completed block.
+  * @param  uint8_t c
+  * @retval uint8_t STATUS_OK, STATUS_PROGRAM_STORAGE_FULL or STATUS_PROGRAM_STORAGE_FAIL
+  */
+static uint8_t _write_char(uint8_t c) {
+    uint32_t block = receive.block + receive.size/NGRBL_HAL_STORAGE_BLOCK_SIZE;
+    uint16_t index = receive.size % NGRBL_HAL_STORAGE_BLOCK_SIZE;
+    /* */
+    if (block == receive.block_end) { return(STATUS_PROGRAM_STORAGE_FULL); }
+    buffer[0][index] = c;
+    receive.size++;
+    if ((index == (NGRBL_HAL_STORAGE_BLOCK_SIZE - 1)) && !ngrbl_hal_storage_write_block(block, buffer[0])) {
+        return(STATUS_PROGRAM_STORAGE_FAIL);
+    }
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Starts the read of the next block of the program into the buffer not being read.
+  * @param  None
+  * @retval None
+  */
+static void _prefetch(void) {
+    if (reader.next_block == reader.block_end) { return; }
+    read_failed = false;
+    read_pending = true;
+    ngrbl_hal_storage_read_block(reader.next_block++, buffer[reader.current ^ 1]);
+}
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  ngrbl_hal_storage_read_callback. Called by the HAL once a ngrbl_hal_storage_read_block()
+            read is complete.
+  * @param  uint8_t success, false if the data could not be read
+  * @retval None
+  */
+void ngrbl_hal_storage_read_callback(uint8_t success) {
+    read_failed = !success;
+    read_pending = false;
+}
+
+/**
+  * @brief  Drops a partially received program and stops reading a running one. Called upon system
+            reset.
+  * @param  None
+  * @retval None
+  */
+void program_store_reset(void) {
+    receive.active = false;
+    reader.active = false;
+}
+
+/**
+  * @brief  Tells if a program is being received, the lines of the program stream then go to
+            program_store_write_line() instead of being executed.
+  * @param  None
+  * @retval true while receiving
+  */
+uint8_t program_store_receiving(void) {
+    return(receive.active);
+}
+
+/**
+  * @brief  Starts receiving a program.
+  * @param  char *name
+  * @retval uint8_t status code
+  */
+uint8_t program_store_begin(char *name) {
+    if (!_check_name(name)) { return(STATUS_INVALID_STATEMENT); }
+    if (reader.active) { return(STATUS_IDLE_ERROR); }
+    uint8_t status = _load_directory();
+    if (status != STATUS_OK) { return(status); }
+    /* A free entry is needed, unless the program replaces one of the same name */
+    if (_find_program(name) == NULL) {
+        uint8_t idx = 0;
+        while ((idx < PROGRAM_STORE_MAX_PROGRAMS) && (directory.directory.entries[idx].name[0] != 0)) { idx++; }
+        if (idx == PROGRAM_STORE_MAX_PROGRAMS) { return(STATUS_PROGRAM_STORAGE_FULL); }
+    }
+    /* */
+    strcpy(receive.name, name);
+    _find_free_blocks(&receive.block, &receive.block_end);
+    receive.size = 0;
+    receive.status = STATUS_OK;
+    receive.active = true;
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Stores one filtered line of the program being received. Empty lines are not stored.
+  * @param  char *line
+  * @retval uint8_t status code, STATUS_OK for the lines after a failed one
+  */
+uint8_t program_store_write_line(char *line) {
+    uint8_t status = STATUS_OK;
+    /* */
+    if ((receive.status != STATUS_OK) || (line[0] == 0)) { return(STATUS_OK); }
+    for (uint8_t idx = 0; line[idx] != 0; idx++) {
+        if ((uint8_t)line[idx] >= 0x80) { status = STATUS_INVALID_STATEMENT; }
+    }
+    for (uint8_t idx = 0; (status == STATUS_OK) && (line[idx] != 0); idx++) {
+        status = _write_char(line[idx]);
+    }
+    if (status == STATUS_OK) { status = _write_char('\n'); }
+    receive.status = status;
+    return(status);
+}
+
+/**
+  * @brief  Fails the program being received upon a line that could not be stored.
+  * @param  uint8_t status, error of the line
+  * @retval uint8_t status code of the line
+  */
+uint8_t program_store_reject_line(uint8_t status) {
+    if (receive.status == STATUS_OK) { receive.status = status; }
+    return(status);
+}
+
+/**
+  * @brief  Ends the program being received, writes its last block and its directory entry.
+  * @param  None
+  * @retval uint8_t status code, the first error of the program if any
+  */
+uint8_t program_store_end(void) {
+    receive.active = false;
+    if (receive.status != STATUS_OK) { return(receive.status); }
+    /* */
+    if ((receive.size % NGRBL_HAL_STORAGE_BLOCK_SIZE) != 0) {
+        uint32_t block = receive.block + receive.size/NGRBL_HAL_STORAGE_BLOCK_SIZE;
+        if (!ngrbl_hal_storage_write_block(block, buffer[0])) { return(STATUS_PROGRAM_STORAGE_FAIL); }
+    }
+    program_entry_t *entry = _find_program(receive.name);
+    if (entry == NULL) {
+        entry = &directory.directory.entries[0];
+        while (entry->name[0] != 0) { entry++; } // Checked free by program_store_begin()
+    }
+    strcpy(entry->name, receive.name);
+    entry->block = receive.block;
+    entry->size = receive.size;
+    return(_store_directory());
+}
+
+/**
+  * @brief  Deletes a stored program.
+  * @param  char *name
+  * @retval uint8_t status code
+  */
+uint8_t program_store_delete(char *name) {
+    if (!_check_name(name)) { return(STATUS_INVALID_STATEMENT); }
+    if (reader.active) { return(STATUS_IDLE_ERROR); }
+    uint8_t status = _load_directory();
+    if (status != STATUS_OK) { return(status); }
+    /* */
+    program_entry_t *entry = _find_program(name);
+    if (entry == NULL) { return(STATUS_PROGRAM_NOT_FOUND); }
+    memset(entry, 0, sizeof(program_entry_t));
+    return(_store_directory());
+}
+
+/**
+  * @brief  Reports the stored programs.
+  * @param  None
+  * @retval None
+  */
+void program_store_list(void) {
+    if (_load_directory() != STATUS_OK) { return; }
+    for (uint8_t idx = 0; idx < PROGRAM_STORE_MAX_PROGRAMS; idx++) {
+        program_entry_t *entry = &directory.directory.entries[idx];
+        if (entry->name[0] != 0) { report_program_entry(entry->name, entry->size); }
+    }
+}
+
+/**
+  * @brief  Opens a stored program to run it. The first block is read at once, the next one is
+            prefetched.
+  * @param  char *name
+  * @retval uint8_t status code
+  */
+uint8_t program_store_open(char *name) {
+    if (!_check_name(name)) { return(STATUS_INVALID_STATEMENT); }
+    if (reader.active || receive.active) { return(STATUS_IDLE_ERROR); }
+    uint8_t status = _load_directory();
+    if (status != STATUS_OK) { return(status); }
+    program_entry_t *entry = _find_program(name);
+    if (entry == NULL) { return(STATUS_PROGRAM_NOT_FOUND); }
+    /* */
+    reader.current = 0;
+    reader.index = 0;
+    reader.next_block = entry->block;
+    reader.block_end = entry->block + PROGRAM_STORE_BLOCKS(entry->size);
+    reader.remaining = entry->size;
+    reader.failed = false;
+    if (reader.next_block != reader.block_end) {
+        status = _read_block_wait(reader.next_block++, buffer[0]);
+        if (status != STATUS_OK) { return(status); }
+    }
+    _prefetch();
+    reader.active = true;
+    return(STATUS_OK);
+}
+
+/**
+  * @brief  Reads the next character of the running program. Switches to the prefetched buffer at
+            the end of a block, and starts the prefetch of the following block.
+  * @param  None
+  * @retval uint8_t character, PROGRAM_STORE_NO_DATA while the next block is read,
+            PROGRAM_STORE_END or PROGRAM_STORE_READ_FAIL
+  */
+uint8_t program_store_read(void) {
+    if (reader.failed) { return(PROGRAM_STORE_READ_FAIL); }
+    if (!reader.active || (reader.remaining == 0)) { return(PROGRAM_STORE_END); }
+    /* */
+    if (reader.index == NGRBL_HAL_STORAGE_BLOCK_SIZE) {
+        if (read_pending) { return(PROGRAM_STORE_NO_DATA); }
+        if (read_failed) {
+            reader.failed = true;
+            return(PROGRAM_STORE_READ_FAIL);
+        }
+        reader.current ^= 1;
+        reader.index = 0;
+        _prefetch();
+    }
+    reader.remaining--;
+    return(buffer[reader.current][reader.index++]);
+}
+
+/**
+  * @brief  Ends the run of a program.
+  * @param  None
+  * @retval uint8_t STATUS_OK, STATUS_PROGRAM_STORAGE_FAIL if a block of the program failed to read
+  */
+uint8_t program_store_close(void) {
+    reader.active = false;
+    return(reader.failed ? STATUS_PROGRAM_STORAGE_FAIL : STATUS_OK);
+}
+
+/**
+  * @brief  Tells if a program runs.
+  * @param  None
+  * @retval true while running
+  */
+uint8_t program_store_running(void) {
+    return(reader.active);
+}
+
+#else
+
+/**
+  * @brief  ngrbl_hal_storage_read_callback. Defined without the program store as well, the storage
+            defaults of the HAL call it.
+  * @param  uint8_t success
+  * @retval None
+  */
+void ngrbl_hal_storage_read_callback(uint8_t success) { (void)success; }
+
+#endif  /* PROGRAM_STORE */
+
+/******************************************************************************
+      END FILE
+******************************************************************************/
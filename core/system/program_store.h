@@ -0,0 +1,64 @@
+/**
+  ******************************************************************************
+  * @file    program_store.h
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Local program storage on the block storage HAL, and the prefetching reader running
+             stored programs.
+  ******************************************************************************
+**/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GRBL_PROGRAM_STORE_H
+#define __GRBL_PROGRAM_STORE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "nuts_bolts.h"
+#include "hal_abstract.h"
+
+/* Exported define -----------------------------------------------------------*/
+/* Storage layout, in blocks of NGRBL_HAL_STORAGE_BLOCK_SIZE bytes:
+     block 0      directory, a magic word followed by the program entries
+     block 1..    program data, each program in consecutive blocks
+   Programs are stored as their filtered lines, each terminated by '\n'. A new program takes the
+   largest free run of blocks, and replaces a program of the same name once completely stored. */
+#define PROGRAM_STORE_MAGIC         0x5350474E  // "NGPS"
+#define PROGRAM_NAME_LENGTH         15          // Characters of a program name, A-Z, 0-9, '_', '-' and '.'
+#define PROGRAM_STORE_MAX_PROGRAMS  ((NGRBL_HAL_STORAGE_BLOCK_SIZE - sizeof(uint32_t))/sizeof(program_entry_t))
+
+/* program_store_read() values besides characters */
+#define PROGRAM_STORE_NO_DATA       0xFF        // Next block not read yet, retry
+#define PROGRAM_STORE_END           0x00        // End of the program
+#define PROGRAM_STORE_READ_FAIL     0xFE        // A block failed to read, the program ends
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported typedef ----------------------------------------------------------*/
+typedef struct {
+    char name[PROGRAM_NAME_LENGTH + 1];   // Zero-terminated, empty for a free entry
+    uint32_t block;                       // First data block
+    uint32_t size;                        // Bytes
+} program_entry_t;
+
+/* Exported variables --------------------------------------------------------*/
+/* Exported function ---------------------------------------------------------*/
+extern void program_store_reset(void);
+extern uint8_t program_store_receiving(void);
+extern uint8_t program_store_begin(char *name);
+extern uint8_t program_store_write_line(char *line);
+extern uint8_t program_store_reject_line(uint8_t status);
+extern uint8_t program_store_end(void);
+extern uint8_t program_store_delete(char *name);
+extern void program_store_list(void);
+extern uint8_t program_store_open(char *name);
+extern uint8_t program_store_read(void);
+extern uint8_t program_store_close(void);
+extern uint8_t program_store_running(void);
+
+
+#endif /* __GRBL_PROGRAM_STORE_H */
+/******************************************************************************
+      END FILE
+******************************************************************************/
@@ -9,6 +9,7 @@
 **/
 
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "protocol.h"
 #include "serial.h"
 #include "system.h"
@@ -21,18 +22,61 @@
 #include "limits.h"
 #include "report.h"
 #include "nuts_bolts.h"
+#include "motion_control.h"
+#ifdef BINARY_MOTION_PROTOCOL
+  #include "binary_protocol.h"
+#endif
+#ifdef OWORD_SUBROUTINES
+  #include "oword.h"
+#endif
+#ifdef PROGRAM_STORE
+  #include "program_store.h"
+#endif
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
+/* Line assembly state of a serial channel */
+typedef struct {
+  char *line;             // Line being assembled. Zero-terminated upon execution.
+  uint8_t char_counter;
+  uint8_t line_flags;
+  #ifdef LINE_CHECKSUM_PROTOCOL
+    uint16_t checksum;    // Checksum of the line being assembled, see protocol_checksum_char()
+  #endif
+} protocol_channel_t;
+
 /* Private define ------------------------------------------------------------*/
 /* define line flags, includes comment type tracking
    and line overflow detection */
 #define LINE_FLAG_OVERFLOW bit(0)
 #define LINE_FLAG_COMMENT_PARENTHESES bit(1)
 #define LINE_FLAG_COMMENT_SEMICOLON bit(2)
+#define LINE_FLAG_PROGRAM bit(3)  // Line of a stored program, only passed to protocol_execute_line()
+
+#ifdef LINE_CHECKSUM_PROTOCOL
+  #define LINE_CHECKSUM_END   bit(8)  // Checksum '*' found, the line checksum is complete
+  #define LINE_CHECKSUM_MAX   255
+#endif
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 static char line[LINE_BUFFER_SIZE]; // Line to be executed. Zero-terminated.
+#if (SERIAL_CHANNELS > 1)
+  // Each channel assembles its lines separately. '$' commands still run from the line buffer.
+  static char channel_line[SERIAL_CHANNELS][LINE_BUFFER_SIZE];
+#endif
+static protocol_channel_t channels[SERIAL_CHANNELS];
+#ifdef PROGRAM_STORE
+  static char program_line[LINE_BUFFER_SIZE]; // Line of the running stored program
+#endif
+#ifdef LINE_CHECKSUM_PROTOCOL
+  static uint16_t line_checksum;         // Checksum of the line being executed, see LINE_CHECKSUM_END
+  static uint32_t line_sequence_next;    // Line number expected next
+  static uint8_t line_sequence_synced;   // Line sequence started, cleared upon reset
+  static uint8_t line_resend_requested;  // Resend of line_sequence_next requested, rejecting until it arrives
+#endif
 
 /* Private function prototypes -----------------------------------------------*/
 /* Extern function -----------------------------------------------------------*/
@@ -305,6 +349,310 @@ static void protocol_exec_rt_suspend(void) {
 
 /* Exported Functions --------------------------------------------------------*/
 
+/**
+  * @brief  Performs the initial filtering of one received character of a line: removes spaces and
+            comments, capitalizes all letters and detects line buffer overflow.
+            NOTE: Writes at most one character per call, so a line may be filtered in place.
+  * @param  char *dst, uint8_t c, uint8_t *char_counter, uint8_t *line_flags
+  * @retval None
+  */
+static void protocol_filter_char(char *dst, uint8_t c, uint8_t *char_counter, uint8_t *line_flags) {
+  if (*line_flags) {
+    // Throw away all (except EOL) comment characters and overflow characters.
+    if (c == ')') {
+      // End of '()' comment. Resume line allowed.
+      if (*line_flags & LINE_FLAG_COMMENT_PARENTHESES) { *line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES); }
+    }
+  } else {
+    if (c <= ' ') {
+      // Throw away whitepace and control characters
+    #ifdef PARAMETRIC_GCODE
+    } else if ((c == '/') && (*char_counter == 0)) {
+      // Block delete NOT SUPPORTED. Ignore character. Within the line '/' divides in expressions.
+    #else
+    } else if (c == '/') {
+      // Block delete NOT SUPPORTED. Ignore character.
+      // NOTE: If supported, would simply need to check the system if block delete is enabled.
+    #endif
+    } else if (c == '(') {
+      // Enable comments flag and ignore all characters until ')' or EOL.
+      // NOTE: This doesn't follow the NIST definition exactly, but is good enough for now.
+      // In the future, we could simply remove the items within the comments, but retain the
+      // comment control characters, so that the g-code parser can error-check it.
+      *line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
+    } else if (c == ';') {
+      // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
+      *line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
+    // TODO: Install '%' feature
+    // } else if (c == '%') {
+      // Program start-end percent sign NOT SUPPORTED.
+      // NOTE: This maybe installed to tell Grbl when a program is running vs manual input,
+      // where, during a program, the system auto-cycle start will continue to execute
+      // everything until the next '%' sign. This will help fix resuming issues with certain
+      // functions that empty the planner buffer to execute its task on-time.
+    } else if (*char_counter >= (LINE_BUFFER_SIZE-1)) {
+      // Detect line buffer overflow and set flag.
+      *line_flags |= LINE_FLAG_OVERFLOW;
+    } else if (c >= 'a' && c <= 'z') { // Upcase lowercase
+      dst[(*char_counter)++] = c-'a'+'A';
+    } else {
+      dst[(*char_counter)++] = c;
+    }
+  }
+}
+
+#ifdef LINE_CHECKSUM_PROTOCOL
+/**
+  * @brief  Adds one raw line character to a line checksum, up to the checksum '*'.
+  * @param  uint16_t *checksum, uint8_t c
+  * @retval None
+  */
+static void protocol_checksum_char(uint16_t *checksum, uint8_t c) {
+  if (*checksum & LINE_CHECKSUM_END) { return; }
+  if (c == '*') { *checksum |= LINE_CHECKSUM_END; }
+  else { *checksum ^= c; }
+}
+
+/**
+  * @brief  Checks the checksum and the sequence of a numbered line and strips the checksum from it.
+            Requests a resend of the expected line upon a corrupt or missing line.
+  * @param  char *block, starting with 'N', uint8_t *execute, cleared for lines already executed
+  * @retval uint8_t STATUS_OK, STATUS_LINE_CHECKSUM or STATUS_LINE_SEQUENCE
+  */
+static uint8_t protocol_check_line_sequence(char *block, uint8_t *execute) {
+  uint8_t char_counter = 1;
+  float value;
+  uint32_t line_number = 0;
+  uint8_t status = STATUS_OK;
+  char *checksum_ptr = strchr(block, '*');
+  /* */
+  *execute = true;
+  if ((checksum_ptr == NULL) || !(line_checksum & LINE_CHECKSUM_END)) {
+    status = STATUS_LINE_CHECKSUM;
+  } else {
+    // Checksum must be the last word, plain decimal digits only.
+    uint16_t checksum = 0;
+    char *ptr = checksum_ptr + 1;
+    if (*ptr == 0) { status = STATUS_LINE_CHECKSUM; }
+    while ((*ptr != 0) && (status == STATUS_OK)) {
+      if ((*ptr < '0') || (*ptr > '9')) { status = STATUS_LINE_CHECKSUM; }
+      else { checksum = 10*checksum + (*ptr - '0'); }
+      if (checksum > LINE_CHECKSUM_MAX) { status = STATUS_LINE_CHECKSUM; }
+      ptr++;
+    }
+    if ((status == STATUS_OK) && (checksum != (line_checksum & 0xFF))) { status = STATUS_LINE_CHECKSUM; }
+  }
+  if (status == STATUS_OK) {
+    if (!read_float(block, &char_counter, &value) || (value < 0.0f)) { status = STATUS_LINE_CHECKSUM; }
+    else { line_number = (uint32_t)value; }
+  }
+  /* */
+  if (status == STATUS_OK) {
+    *checksum_ptr = 0; // Strip checksum for the parser.
+    if ((line_number == 0) || !line_sequence_synced || (line_number == line_sequence_next)) {
+      // Expected line, or start of a new sequence.
+      line_sequence_synced = true;
+      line_sequence_next = line_number + 1;
+      line_resend_requested = false;
+      return(STATUS_OK);
+    }
+    if (line_number < line_sequence_next) {
+      // Already executed, resent by the host after a resend request. Acknowledge only.
+      *execute = false;
+      return(STATUS_OK);
+    }
+    status = STATUS_LINE_SEQUENCE; // Line(s) missing.
+  }
+  // Corrupt or out of sequence. Request the expected line once and reject until it arrives.
+  if (!line_resend_requested && line_sequence_synced) {
+    line_resend_requested = true;
+    report_resend_request(line_sequence_next);
+  }
+  return(status);
+}
+#endif
+
+/**
+  * @brief  Directs and executes one line of formatted input.
+  * @param  char *block, zero-terminated, uint8_t line_flags
+  * @retval uint8_t status code of the execution
+  */
+static uint8_t protocol_execute_line(char *block, uint8_t line_flags) {
+  #ifdef REPORT_ECHO_LINE_RECEIVED
+    report_echo_line_received(block);
+  #endif
+
+  if (line_flags & LINE_FLAG_OVERFLOW) {
+    // Report line overflow error.
+    #ifdef PROGRAM_STORE
+      if ((serial_get_channel() == SERIAL_CHANNEL_MAIN) && program_store_receiving()) {
+        return(program_store_reject_line(STATUS_OVERFLOW)); // The program lacks the line
+      }
+    #endif
+    return(STATUS_OVERFLOW);
+  }
+  #ifdef LINE_CHECKSUM_PROTOCOL
+    if ((block[0] == 'N') && (serial_get_channel() == SERIAL_CHANNEL_MAIN) && !(line_flags & LINE_FLAG_PROGRAM)) {
+      // Numbered line of the program stream, check checksum and sequence.
+      uint8_t execute;
+      uint8_t status = protocol_check_line_sequence(block, &execute);
+      if ((status != STATUS_OK) || !execute) { return(status); }
+    }
+  #endif
+  #ifdef PROGRAM_STORE
+    if (!(line_flags & LINE_FLAG_PROGRAM) && (serial_get_channel() == SERIAL_CHANNEL_MAIN) && program_store_receiving()) {
+      // Program being received is stored, not executed. A '$F' line ends it.
+      if ((block[0] == '$') && (block[1] == 'F') && (block[2] == 0)) { return(program_store_end()); }
+      return(program_store_write_line(block));
+    }
+  #endif
+  if (block[0] == 0) {
+    // Empty or comment line. For syncing purposes.
+    return(STATUS_OK);
+  } else if (block[0] == '$') {
+    // Grbl '$' system command
+    // NOTE: Some system commands use the line as a LINE_BUFFER_SIZE work buffer, so always run
+    // them from the line buffer.
+    if (block != line) { strcpy(line, block); }
+    return(system_execute_line(line));
+  } else if (sys.state & (STATE_ALARM | STATE_JOG)) {
+    // Everything else is gcode. Block if in alarm or jog mode.
+    return(STATUS_SYSTEM_GC_LOCK);
+  }
+  #ifdef OWORD_SUBROUTINES
+    // O-word lines, and the body lines of a subroutine or loop, of the program stream.
+    uint8_t status;
+    if (oword_execute_line(block, &status)) { return(status); }
+  #endif
+  // Parse and execute g-code block.
+  return(gc_execute_line(block));
+}
+
+/**
+  * @brief  Executes the next line in place in the serial RX buffer of the selected channel, if it is
+            complete and does not wrap around the end of the ring. Saves the copy into the line buffer
+            and the per byte serial_read() calls. Lines not taken here go through the byte-wise line
+            assembly.
+  * @param  protocol_channel_t *ch, the selected channel, with no line characters assembled
+  * @retval true if a line has been executed
+  */
+static uint8_t protocol_execute_line_in_place(protocol_channel_t *ch) {
+  uint8_t *span;
+  uint16_t span_length = serial_get_rx_span(&span);
+  uint16_t eol = 0;
+  // Find the end of line within the contiguous span.
+  while (eol != span_length) {
+    uint8_t c = span[eol];
+    if ((c == '\n') || (c == '\r')) { break; }
+    #ifdef BINARY_MOTION_PROTOCOL
+      if (c == BIN_FRAME_START) { return(false); } // Leave frames to the byte-wise path.
+    #endif
+    eol++;
+  }
+  if (eol == span_length) { return(false); }
+
+  protocol_execute_realtime(); // Runtime command check point.
+  if (sys.abort) { return(true); } // Caller bails upon system abort
+
+  // Filter the line in one pass over the span and terminate it at the end of line character.
+  uint8_t line_flags = 0;
+  uint8_t char_counter = 0;
+  #ifdef LINE_CHECKSUM_PROTOCOL
+    // Continue the checksum of any characters already read, as leading spaces.
+    line_checksum = ch->checksum;
+    ch->checksum = 0;
+    for (uint16_t idx = 0; idx != eol; idx++) {
+      protocol_checksum_char(&line_checksum, span[idx]);
+      protocol_filter_char((char*)span, span[idx], &char_counter, &line_flags);
+    }
+  #else
+    (void)ch;
+    for (uint16_t idx = 0; idx != eol; idx++) {
+      protocol_filter_char((char*)span, span[idx], &char_counter, &line_flags);
+    }
+  #endif
+  span[char_counter] = 0;
+
+  uint8_t status = protocol_execute_line((char*)span, line_flags);
+  // Release the line before responding, the host may send the next one upon the response.
+  serial_consume_rx(eol + 1);
+  report_status_message(status);
+  return(true);
+}
+
+/**
+  * @brief  Processes incoming serial data of a channel, as the data becomes available. Complete lines
+            are executed in place in the serial buffer. Otherwise performs an initial filtering of each
+            character into the channel line by removing spaces and comments and capitalizing all letters.
+            Binary motion frames are taken from the main channel only.
+  * @param  uint8_t channel, uint8_t line_limit, lines to execute at most, 0 for no limit
+  * @retval None, returns with no more data, with the line limit reached or upon system abort
+  */
+static void protocol_read_channel(uint8_t channel, uint8_t line_limit) {
+  protocol_channel_t *ch = &channels[channel];
+  uint8_t lines = 0;
+  uint8_t c;
+  /* */
+  serial_select_channel(channel);
+  for (;;) {
+    if ((line_limit != 0) && (lines == line_limit)) { return; }
+    #ifdef BINARY_MOTION_PROTOCOL
+    if ((ch->char_counter == 0) && (ch->line_flags == 0) &&
+        ((channel != SERIAL_CHANNEL_MAIN) || !binary_protocol_frame_pending())) {
+    #else
+    if ((ch->char_counter == 0) && (ch->line_flags == 0)) {
+    #endif
+      if (protocol_execute_line_in_place(ch)) {
+        if (sys.abort) { return; } // Bail to calling function upon system abort
+        lines++;
+        continue;
+      }
+    }
+    if ((c = serial_read()) == SERIAL_NO_DATA) { return; }
+
+    #ifdef BINARY_MOTION_PROTOCOL
+      // Binary motion frames are taken off the stream and executed in order with text lines.
+      if (channel == SERIAL_CHANNEL_MAIN) {
+        uint8_t frame_state = binary_protocol_process_byte(c);
+        if (frame_state == BIN_FRAME_PENDING) { continue; }
+        if (frame_state == BIN_FRAME_COMPLETE) {
+          protocol_execute_realtime(); // Runtime command check point.
+          if (sys.abort) { return; } // Bail to calling function upon system abort
+          report_status_message(binary_protocol_execute_frame());
+          lines++;
+          continue;
+        }
+      }
+    #endif
+    if ((c == '\n') || (c == '\r')) { // End of line reached
+
+      protocol_execute_realtime(); // Runtime command check point.
+      if (sys.abort) { return; } // Bail to calling function upon system abort
+
+      ch->line[ch->char_counter] = 0; // Set string termination character.
+      #ifdef LINE_CHECKSUM_PROTOCOL
+        line_checksum = ch->checksum;
+      #endif
+      // Direct and execute one line of formatted input, and report status of execution.
+      report_status_message(protocol_execute_line(ch->line, ch->line_flags));
+      lines++;
+
+      // Reset tracking data for next line.
+      ch->line_flags = 0;
+      ch->char_counter = 0;
+      #ifdef LINE_CHECKSUM_PROTOCOL
+        ch->checksum = 0;
+      #endif
+
+    } else {
+      #ifdef LINE_CHECKSUM_PROTOCOL
+        protocol_checksum_char(&ch->checksum, c);
+      #endif
+      protocol_filter_char(ch->line, c, &ch->char_counter, &ch->line_flags);
+    }
+  }
+}
+
 /**
   * @brief  GRBL PRIMARY LOOP:
   * @param  None
@@ -342,88 +690,45 @@ void protocol_main_loop(void) {
   // This is also where Grbl idles while waiting for something to do.
   // ---------------------------------------------------------------------------------
 
-  uint8_t line_flags = 0;
-  uint8_t char_counter = 0;
-  uint8_t c;
+  for (uint8_t channel = 0; channel < SERIAL_CHANNELS; channel++) {
+    #if (SERIAL_CHANNELS > 1)
+      channels[channel].line = channel_line[channel];
+    #else
+      channels[channel].line = line;
+    #endif
+    channels[channel].char_counter = 0;
+    channels[channel].line_flags = 0;
+    #ifdef LINE_CHECKSUM_PROTOCOL
+      channels[channel].checksum = 0;
+    #endif
+  }
+  #ifdef BINARY_MOTION_PROTOCOL
+    binary_protocol_reset();
+  #endif
+  #ifdef OWORD_SUBROUTINES
+    oword_reset();
+  #endif
+  #ifdef PROGRAM_STORE
+    program_store_reset();
+  #endif
+  #ifdef PROGRAM_VALIDATION
+    validation_reset();
+  #endif
+  #ifdef LINE_CHECKSUM_PROTOCOL
+    line_sequence_synced = false;
+    line_resend_requested = false;
+  #endif
   for (;;) {
 
-    // Process one line of incoming serial data, as the data becomes available. Performs an
-    // initial filtering by removing spaces and comments and capitalizing all letters.
-    while((c = serial_read()) != SERIAL_NO_DATA) {
-      if ((c == '\n') || (c == '\r')) { // End of line reached
-
-        protocol_execute_realtime(); // Runtime command check point.
-        if (sys.abort) { return; } // Bail to calling function upon system abort
-
-        line[char_counter] = 0; // Set string termination character.
-        #ifdef REPORT_ECHO_LINE_RECEIVED
-          report_echo_line_received(line);
-        #endif
-
-        // Direct and execute one line of formatted input, and report status of execution.
-        if (line_flags & LINE_FLAG_OVERFLOW) {
-          // Report line overflow error.
-          report_status_message(STATUS_OVERFLOW);
-        } else if (line[0] == 0) {
-          // Empty or comment line. For syncing purposes.
-          report_status_message(STATUS_OK);
-        } else if (line[0] == '$') {
-          // Grbl '$' system command
-          report_status_message(system_execute_line(line));
-        } else if (sys.state & (STATE_ALARM | STATE_JOG)) {
-          // Everything else is gcode. Block if in alarm or jog mode.
-          report_status_message(STATUS_SYSTEM_GC_LOCK);
-        } else {
-          // Parse and execute g-code block.
-          report_status_message(gc_execute_line(line));
-        }
-
-        // Reset tracking data for next line.
-        line_flags = 0;
-        char_counter = 0;
-
-      } else {
-
-        if (line_flags) {
-          // Throw away all (except EOL) comment characters and overflow characters.
-          if (c == ')') {
-            // End of '()' comment. Resume line allowed.
-            if (line_flags & LINE_FLAG_COMMENT_PARENTHESES) { line_flags &= ~(LINE_FLAG_COMMENT_PARENTHESES); }
-          }
-        } else {
-          if (c <= ' ') {
-            // Throw away whitepace and control characters
-          } else if (c == '/') {
-            // Block delete NOT SUPPORTED. Ignore character.
-            // NOTE: If supported, would simply need to check the system if block delete is enabled.
-          } else if (c == '(') {
-            // Enable comments flag and ignore all characters until ')' or EOL.
-            // NOTE: This doesn't follow the NIST definition exactly, but is good enough for now.
-            // In the future, we could simply remove the items within the comments, but retain the
-            // comment control characters, so that the g-code parser can error-check it.
-            line_flags |= LINE_FLAG_COMMENT_PARENTHESES;
-          } else if (c == ';') {
-            // NOTE: ';' comment to EOL is a LinuxCNC definition. Not NIST.
-            line_flags |= LINE_FLAG_COMMENT_SEMICOLON;
-          // TODO: Install '%' feature
-          // } else if (c == '%') {
-            // Program start-end percent sign NOT SUPPORTED.
-            // NOTE: This maybe installed to tell Grbl when a program is running vs manual input,
-            // where, during a program, the system auto-cycle start will continue to execute
-            // everything until the next '%' sign. This will help fix resuming issues with certain
-            // functions that empty the planner buffer to execute its task on-time.
-          } else if (char_counter >= (LINE_BUFFER_SIZE-1)) {
-            // Detect line buffer overflow and set flag.
-            line_flags |= LINE_FLAG_OVERFLOW;
-          } else if (c >= 'a' && c <= 'z') { // Upcase lowercase
-            line[char_counter++] = c-'a'+'A';
-          } else {
-            line[char_counter++] = c;
-          }
-        }
-
-      }
+    // The program stream of the main channel has priority and is read as long as it has data.
+    // Each other channel then gets one line per pass. Responses go back to the channel of the line.
+    protocol_read_channel(SERIAL_CHANNEL_MAIN, 0);
+    if (sys.abort) { return; } // Bail to calling function upon system abort
+    for (uint8_t channel = 1; channel < SERIAL_CHANNELS; channel++) {
+      protocol_read_channel(channel, 1);
+      if (sys.abort) { return; } // Bail to calling function upon system abort
     }
+    serial_set_output(SERIAL_OUTPUT_ALL);
 
     // If there are no more characters in the serial read buffer to be processed and executed,
     // this indicates that g-code streaming has either filled the planner buffer or has
@@ -437,6 +742,93 @@ void protocol_main_loop(void) {
   return; /* Never reached */
 }
 
+#ifdef PROGRAM_STORE
+/**
+  * @brief  Reads the next line of the program opened by program_store_open() into program_line.
+            Keeps up with realtime commands while the next block is read.
+  * @param  uint8_t *line_flags, set to the flags of the line
+  * @retval true if a line has been read, false at the end of the program, upon a block read error
+            or system abort. The line a read error cuts is dropped.
+  */
+static uint8_t protocol_read_program_line(uint8_t *line_flags) {
+  uint8_t char_counter = 0;
+  uint8_t c;
+  *line_flags = 0;
+  for (;;) {
+    if ((c = program_store_read()) == PROGRAM_STORE_NO_DATA) {
+      // Next block still read, keep up with realtime commands meanwhile.
+      protocol_execute_realtime();
+      if (sys.abort) { return(false); }
+      continue;
+    }
+    if (c == PROGRAM_STORE_READ_FAIL) { return(false); }
+    if ((c == '\n') || (c == PROGRAM_STORE_END)) {
+      if ((char_counter != 0) || (*line_flags != 0)) {
+        program_line[char_counter] = 0;
+        return(true);
+      }
+      if (c == PROGRAM_STORE_END) { return(false); }
+    } else {
+      protocol_filter_char(program_line, c, &char_counter, line_flags);
+    }
+  }
+}
+
+/**
+  * @brief  Runs the program opened by program_store_open(). Its lines go through the same line
+            processing as lines of the program stream, read from the program store instead of the
+            serial buffer. Returns upon the end of the program, its first error or system abort.
+  * @param  None
+  * @retval uint8_t status code, of the first failing line, STATUS_PROGRAM_STORAGE_FAIL if the
+            program failed to read or STATUS_OK
+  */
+uint8_t protocol_execute_program(void) {
+  uint8_t line_flags;
+  uint8_t status = STATUS_OK;
+  /* */
+  while (protocol_read_program_line(&line_flags)) {
+    protocol_execute_realtime(); // Runtime command check point.
+    if (sys.abort) { break; } // Bail to calling function upon system abort
+    status = protocol_execute_line(program_line, line_flags | LINE_FLAG_PROGRAM);
+    if ((status != STATUS_OK) || sys.abort) { break; }
+  }
+  if (program_store_close() != STATUS_OK) { status = STATUS_PROGRAM_STORAGE_FAIL; }
+  return(status);
+}
+
+#ifdef PROGRAM_VALIDATION
+/**
+  * @brief  Validates the program opened by program_store_open(). Its lines go through the line
+            processing in check mode as fast as they parse, realtime commands are only checked
+            every VALIDATION_REALTIME_LINES lines. A failing line is logged and the program goes on.
+            Reports the summary of the validation at the end of the program.
+  * @param  uint8_t mode, VALIDATION_CHECK or VALIDATION_SIMULATE
+  * @retval uint8_t STATUS_OK, STATUS_PROGRAM_STORAGE_FAIL if the program failed to read, which
+            ends the validation with the lines read
+  */
+uint8_t protocol_validate_program(uint8_t mode) {
+  uint8_t line_flags;
+  uint8_t realtime_lines = 0;
+  uint8_t status;
+  /* */
+  validation_begin(mode);
+  while (protocol_read_program_line(&line_flags)) {
+    if (++realtime_lines == VALIDATION_REALTIME_LINES) {
+      realtime_lines = 0;
+      protocol_execute_realtime(); // Runtime command check point.
+      if (sys.abort) { break; } // Bail to calling function upon system abort
+    }
+    validation_line(protocol_execute_line(program_line, line_flags | LINE_FLAG_PROGRAM));
+    if (sys.abort) { break; }
+  }
+  status = program_store_close();
+  if (sys.abort) { return(STATUS_OK); } // Reset restores the parser state, no summary
+  validation_end();
+  return(status);
+}
+#endif
+#endif
+
 /**
   * @brief  Block until all buffered steps are executed or in a cycle state. Works with feed hold
             during a synchronize call, if it should happen. Also, waits for clean cycle end.
@@ -444,6 +836,13 @@ void protocol_main_loop(void) {
   * @retval None
   */
 void protocol_buffer_synchronize(void) {
+  #ifdef PROGRAM_SIMULATION
+    // A simulated job has no stepper interrupt to wait for, its planned motions are taken here.
+    if (validation_active()) {
+      validation_synchronize();
+      return;
+    }
+  #endif
   // If system is queued, ensure cycle resumes if the auto start flag is present.
   protocol_auto_cycle_start();
   do {
@@ -505,6 +904,7 @@ void protocol_exec_rt_system(void) {
       // the source of the error to the user. If critical, Grbl disables by entering an infinite
       // loop until system reset/abort.
       sys.state = STATE_ALARM; // Set system alarm state
+      uint8_t output = serial_set_output(SERIAL_OUTPUT_ALL); // Alarms go to all channels.
       report_alarm_message(rt_exec);
       // Halt everything upon a critical event flag. Currently hard and soft limits flag this.
       if ((rt_exec == EXEC_ALARM_HARD_LIMIT) || (rt_exec == EXEC_ALARM_SOFT_LIMIT)) {
@@ -518,9 +918,33 @@ void protocol_exec_rt_system(void) {
           // lost, continued streaming could cause a serious crash if by chance it gets executed.
         } while (bit_isfalse(sys_rt_exec_state,EXEC_RESET));
       }
+      serial_set_output(output);
       system_clear_exec_alarm(); // Clear alarm
     }
 
+    // Push a status report at the auto report interval, or at once upon a state change.
+    if (settings.status_report_interval) {
+      if ((sys.state != sys.report_last_state) || (sys.suspend != sys.report_last_suspend)) {
+        system_set_exec_report_flag(EXEC_STATUS_REPORT_PUSHED);
+      }
+      if (sys_rt_exec_report & EXEC_STATUS_REPORT_PUSHED) {
+        uint8_t output = serial_set_output(SERIAL_OUTPUT_ALL);
+        report_realtime_status_pushed();
+        serial_set_output(output);
+        system_clear_exec_report_flag(EXEC_STATUS_REPORT_PUSHED);
+      }
+    }
+
+    #ifdef REPORT_BINARY_STATUS
+      // Execute and serial send binary status frame
+      if (sys_rt_exec_report & EXEC_BINARY_STATUS_REPORT) {
+        uint8_t output = serial_set_output(serial_take_report_requests(SERIAL_REQUEST_STATUS_BINARY));
+        report_realtime_status_binary();
+        serial_set_output(output);
+        system_clear_exec_report_flag(EXEC_BINARY_STATUS_REPORT);
+      }
+    #endif
+
     rt_exec = sys_rt_exec_state; // Copy volatile sys_rt_exec_state.
     if (rt_exec) {
 
@@ -532,7 +956,10 @@ void protocol_exec_rt_system(void) {
 
       // Execute and serial print status
       if (rt_exec & EXEC_STATUS_REPORT) {
+        // Answer the requesting channels only.
+        uint8_t output = serial_set_output(serial_take_report_requests(SERIAL_REQUEST_STATUS));
         report_realtime_status();
+        serial_set_output(output);
         system_clear_exec_state_flag(EXEC_STATUS_REPORT);
       }
 
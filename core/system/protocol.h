@@ -37,6 +37,12 @@ extern void protocol_execute_realtime();
 extern void protocol_exec_rt_system();
 extern void protocol_auto_cycle_start();
 extern void protocol_buffer_synchronize();
+#ifdef PROGRAM_STORE
+  extern uint8_t protocol_execute_program(void);
+  #ifdef PROGRAM_VALIDATION
+    extern uint8_t protocol_validate_program(uint8_t mode);
+  #endif
+#endif
 
 
 #endif /* __GRBL_PROTOCOL_H */
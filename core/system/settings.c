@@ -32,6 +32,7 @@ const settings_t defaults = { \
     // .step_invert_mask = DEFAULT_STEPPING_INVERT_MASK,
     // .dir_invert_mask = DEFAULT_DIRECTION_INVERT_MASK,
     .status_report_mask = DEFAULT_STATUS_REPORT_MASK,
+    .status_report_interval = DEFAULT_STATUS_REPORT_INTERVAL,
     .junction_deviation = DEFAULT_JUNCTION_DEVIATION,
     .arc_tolerance = DEFAULT_ARC_TOLERANCE,
     .rpm_max = DEFAULT_SPINDLE_RPM_MAX,
@@ -60,7 +61,10 @@ const settings_t defaults = { \
     .acceleration[Z_AXIS] = DEFAULT_Z_ACCELERATION,
     .max_travel[X_AXIS] = (-DEFAULT_X_MAX_TRAVEL),
     .max_travel[Y_AXIS] = (-DEFAULT_Y_MAX_TRAVEL),
-    .max_travel[Z_AXIS] = (-DEFAULT_Z_MAX_TRAVEL)
+    .max_travel[Z_AXIS] = (-DEFAULT_Z_MAX_TRAVEL),
+    .max_jerk[X_AXIS] = DEFAULT_X_MAX_JERK,
+    .max_jerk[Y_AXIS] = DEFAULT_Y_MAX_JERK,
+    .max_jerk[Z_AXIS] = DEFAULT_Z_MAX_JERK
 };
 
 /* Private function prototypes -----------------------------------------------*/
@@ -274,6 +278,7 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
               break;
             case 2: settings.acceleration[parameter] = value*60*60; break; // Convert to mm/min^2 for grbl internal use.
             case 3: settings.max_travel[parameter] = -value; break;  // Store as negative for grbl internal use.
+            case 4: settings.max_jerk[parameter] = value; break;
           }
           break; // Exit while-loop after setting has been configured and proceed to the EEPROM write call.
         } else {
@@ -320,6 +325,10 @@ uint8_t settings_store_global_setting(uint8_t parameter, float value) {
           else { settings.flags &= ~BITFLAG_REPORT_INCHES; }
           system_flag_wco_change(); // Make sure WCO is immediately updated.
           break;
+        case 15:
+          if (value > 65535.0) { return(STATUS_INVALID_STATEMENT); }
+          settings.status_report_interval = trunc(value);
+          break;
         case 20:
           if (int_value) {
             if (bit_isfalse(settings.flags, BITFLAG_HOMING_ENABLE)) { return(STATUS_SOFT_LIMIT_ERROR); }
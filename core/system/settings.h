@@ -23,7 +23,7 @@
 
 // Version of the EEPROM data. Will be used to migrate existing data from older versions of Grbl
 // when firmware is upgraded. Always stored in byte 0 of eeprom
-#define SETTINGS_VERSION 10  // NOTE: Check settings_reset() when moving to next version.
+#define SETTINGS_VERSION 12  // NOTE: Check settings_reset() when moving to next version.
 
 // Define bit flag masks for the boolean settings in settings.flag.
 #define BIT_REPORT_INCHES      0
@@ -75,7 +75,7 @@
 // #define SETTING_INDEX_G92    N_COORDINATE_SYSTEM+2  // Coordinate offset (G92.2,G92.3 not supported)
 
 // Define Grbl axis settings numbering scheme. Starts at START_VAL, every INCREMENT, over N_SETTINGS.
-#define AXIS_N_SETTINGS          4
+#define AXIS_N_SETTINGS          5
 #define AXIS_SETTINGS_START_VAL  100 // NOTE: Reserving settings values >= 100 for axis settings. Up to 255.
 #define AXIS_SETTINGS_INCREMENT  10  // Must be greater than the number of axis settings
 
@@ -90,6 +90,7 @@ typedef struct _settings_t {
     float max_rate[N_AXIS];
     float acceleration[N_AXIS];
     float max_travel[N_AXIS];
+    float max_jerk[N_AXIS];   // Max instantaneous velocity change at junctions (mm/min)
 
     // Remaining Grbl settings
     uint8_t pulse_microseconds;
@@ -97,6 +98,7 @@ typedef struct _settings_t {
     uint8_t dir_invert_mask;
     uint8_t stepper_idle_lock_time; // If max value 255, steppers do not disable.
     uint8_t status_report_mask; // Mask to indicate desired report data.
+    uint16_t status_report_interval; // Pushed status report period in ms. Zero disables.
     float junction_deviation;
     float arc_tolerance;
 
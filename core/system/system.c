@@ -18,6 +18,12 @@
 #include "motion_control.h"
 #include "stepper.h"
 #include "hal_abstract.h"
+#ifdef PROGRAM_STORE
+  #include "program_store.h"
+#endif
+#ifdef PROGRAM_VALIDATION
+  #include "validation.h"
+#endif
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -105,6 +111,14 @@ uint8_t system_execute_line(char *line) {
       return(gc_execute_line(line)); // NOTE: $J= is ignored inside g-code parser and used to detect jog motions.
       break;
     case '$': case 'G': case 'C': case 'X':
+      #if defined(PROGRAM_STORE) && defined(PROGRAM_VALIDATION)
+        if ((line[1] == 'C') && (line[2] == '=')) { // Validate stored program [IDLE]
+          if ((sys.state != STATE_IDLE) || program_store_running()) { return(STATUS_IDLE_ERROR); }
+          helper_var = program_store_open(&line[3]);
+          if (helper_var) { return(helper_var); }
+          return(protocol_validate_program(VALIDATION_CHECK));
+        }
+      #endif
       if ( line[2] != 0 ) { return(STATUS_INVALID_STATEMENT); }
       switch( line[1] ) {
         case '$' : // Prints Grbl settings
@@ -176,6 +190,14 @@ uint8_t system_execute_line(char *line) {
           }
           break;
         case 'S' : // Puts Grbl to sleep [IDLE/ALARM]
+          #if defined(PROGRAM_STORE) && defined(PROGRAM_SIMULATION)
+            if ((line[2] == 'I') && (line[3] == 'M') && (line[4] == '=')) { // Simulate stored program [IDLE]
+              if ((sys.state != STATE_IDLE) || program_store_running()) { return(STATUS_IDLE_ERROR); }
+              helper_var = program_store_open(&line[5]);
+              if (helper_var) { return(helper_var); }
+              return(protocol_validate_program(VALIDATION_SIMULATE));
+            }
+          #endif
           if ((line[2] != 'L') || (line[3] != 'P') || (line[4] != 0)) { return(STATUS_INVALID_STATEMENT); }
           system_set_exec_state_flag(EXEC_SLEEP); // Set to execute sleep mode immediately
           break;
@@ -194,7 +216,25 @@ uint8_t system_execute_line(char *line) {
           #endif
           }
           break;
+        #ifdef PROGRAM_STORE
+          case 'F' : // Stored programs. [IDLE/ALARM]
+            // Storage is written with the planner empty, a long erase then does not starve a cycle.
+            if ((line[2] != 0) && (plan_get_block_buffer_count() != 0)) { return(STATUS_IDLE_ERROR); }
+            if (line[2] == 0) { program_store_list(); }
+            else if (line[2] == '=') { return(program_store_begin(&line[3])); } // Following lines up to '$F' are stored
+            else if ((line[2] == 'D') && (line[3] == '=')) { return(program_store_delete(&line[4])); }
+            else { return(STATUS_INVALID_STATEMENT); }
+            break;
+        #endif
         case 'R' : // Restore defaults [IDLE/ALARM]
+          #ifdef PROGRAM_STORE
+            if ((line[2] == 'U') && (line[3] == 'N') && (line[4] == '=')) { // Run stored program [IDLE]
+              if ((sys.state != STATE_IDLE) || program_store_running()) { return(STATUS_IDLE_ERROR); }
+              helper_var = program_store_open(&line[5]);
+              if (helper_var) { return(helper_var); }
+              return(protocol_execute_program());
+            }
+          #endif
           if ((line[2] != 'S') || (line[3] != 'T') || (line[4] != '=') || (line[6] != 0)) { return(STATUS_INVALID_STATEMENT); }
           switch (line[5]) {
             #ifdef ENABLE_RESTORE_EEPROM_DEFAULT_SETTINGS
@@ -226,6 +266,7 @@ uint8_t system_execute_line(char *line) {
             helper_var = true;  // Set helper_var to flag storing method.
             // No break. Continues into default: to read remaining command characters.
           }
+          // Falls through.
         default :  // Storing setting methods [IDLE/ALARM]
           if(!read_float(line, &char_counter, &parameter)) { return(STATUS_BAD_NUMBER_FORMAT); }
           if(line[char_counter++] != '=') { return(STATUS_INVALID_STATEMENT); }
@@ -424,6 +465,28 @@ void system_set_exec_accessory_override_flag(uint8_t mask) {
     ngrbl_hal_critical_exit();
 }
 
+/**
+  * @brief  system_set_exec_report_flag
+  * @param  uint8_t mask
+  * @retval None
+  */
+void system_set_exec_report_flag(uint8_t mask) {
+    ngrbl_hal_critical_enter();
+    sys_rt_exec_report |= (mask);
+    ngrbl_hal_critical_exit();
+}
+
+/**
+  * @brief  system_clear_exec_report_flag
+  * @param  uint8_t mask
+  * @retval None
+  */
+void system_clear_exec_report_flag(uint8_t mask) {
+    ngrbl_hal_critical_enter();
+    sys_rt_exec_report &= ~(mask);
+    ngrbl_hal_critical_exit();
+}
+
 /**
   * @brief  system_clear_exec_motion_overrides
   * @param  None
@@ -450,6 +513,25 @@ void system_clear_exec_accessory_overrides(void) {
 
 /* Callbacks -----------------------------------------------------------------*/
 
+/**
+  * @brief  ngrbl_sys_tick_callback. Called by the HAL every millisecond, schedules the pushed status
+            reports at the $15 auto report interval.
+  * @param  None
+  * @retval None
+  */
+void ngrbl_sys_tick_callback(void) {
+    static uint16_t ticks = 0;
+    /* */
+    if (settings.status_report_interval == 0) {
+        ticks = 0;
+        return;
+    }
+    if (++ticks >= settings.status_report_interval) {
+        ticks = 0;
+        system_set_exec_report_flag(EXEC_STATUS_REPORT_PUSHED);
+    }
+}
+
 /**
   * @brief  ngrbl_sys_control_state_change_callback
   * @param  None
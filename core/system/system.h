@@ -133,6 +133,8 @@ typedef struct {
   uint8_t spindle_stop_ovr;    // Tracks spindle stop override states
   uint8_t report_ovr_counter;  // Tracks when to add override data to status reports.
   uint8_t report_wco_counter;  // Tracks when to add work coordinate offset data to status reports.
+  uint8_t report_last_state;   // State and suspend bits of the last status report. Pushes a report
+  uint8_t report_last_suspend; // upon change, if the auto report interval is set.
   #ifdef ENABLE_PARKING_OVERRIDE_CONTROL
     uint8_t override_ctrl;     // Tracks override control states.
   #endif
@@ -155,6 +157,11 @@ extern volatile uint8_t sys_rt_exec_accessory_override; // Global realtime execu
   #define EXEC_DEBUG_REPORT  bit(0)
   extern volatile uint8_t sys_rt_exec_debug;
 #endif
+#define EXEC_STATUS_REPORT_PUSHED  bit(0)
+#ifdef REPORT_BINARY_STATUS
+  #define EXEC_BINARY_STATUS_REPORT  bit(1)
+#endif
+extern volatile uint8_t sys_rt_exec_report; // Realtime executor bitflag variable for additional reports.
 
 /* Exported function ---------------------------------------------------------*/
 extern void system_init(void);
@@ -173,6 +180,8 @@ extern void system_clear_exec_alarm(void);
 extern void system_set_exec_motion_override_flag(uint8_t mask);
 extern void system_set_exec_accessory_override_flag(uint8_t mask);
 extern void system_clear_exec_motion_overrides(void);
+extern void system_set_exec_report_flag(uint8_t mask);
+extern void system_clear_exec_report_flag(uint8_t mask);
 extern void system_clear_exec_accessory_overrides(void);
 
 /* CoreXY calculation only, returns x or y-axis "steps" based on CoreXY motor steps */
@@ -0,0 +1,272 @@
+/**
+  ******************************************************************************
+  * @file    validation.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Validation of whole jobs in check mode. Errors, extents and soft limit violations
+             are accumulated over the job and reported once at its end.
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include "validation.h"
+#include "system.h"
+#include "settings.h"
+#include "gcode.h"
+#include "report.h"
+#ifdef OWORD_SUBROUTINES
+  #include "oword.h"
+#endif
+#ifdef PARAMETRIC_GCODE
+  #include "expression.h"
+#endif
+#ifdef PROGRAM_SIMULATION
+  #include "planner.h"
+  #include "stepper.h"
+#endif
+
+#ifdef PROGRAM_VALIDATION
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t active;
+static validation_summary_t summary;
+static parser_state_t saved_state;
+#ifdef PARAMETRIC_GCODE
+  static float saved_parameters[EXPR_PARAMETERS];
+#endif
+#ifdef PROGRAM_SIMULATION
+  /* Lines of the planned blocks, in the order of the planner buffer */
+  static uint32_t block_line[BLOCK_BUFFER_SIZE];
+  static uint8_t block_head;
+  static uint8_t block_tail;
+  static uint8_t simulate;
+  static uint32_t exec_line;    // Line of the block the segments taken come from
+  static uint32_t time_line;    // Line the run time is added up for, 0 for none yet
+  static uint64_t line_ticks;   // Run time of time_line
+#endif
+
+/* Private function prototypes -----------------------------------------------*/
+/* Extern function -----------------------------------------------------------*/
+/* Private Functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Extends the extents of the job by a machine position.
+  * @param  float *position
+  * @retval None
+  */
+static void _extend(float *position) {
+    for (uint8_t idx = 0; idx < N_AXIS; idx++) {
+        if (position[idx] < summary.min[idx]) { summary.min[idx] = position[idx]; }
+        if (position[idx] > summary.max[idx]) { summary.max[idx] = position[idx]; }
+    }
+}
+
+#ifdef PROGRAM_SIMULATION
+/**
+  * @brief  Adds run time to a line. Reports the run time of the previous line once it is complete.
+  * @param  uint32_t line, uint64_t ticks, stepper timer ticks
+  * @retval None
+  */
+static void _add_time(uint32_t line, uint64_t ticks) {
+    if (line != time_line) {
+        if (time_line != 0) { report_simulation_line(time_line, line_ticks); }
+        time_line = line;
+        line_ticks = 0;
+    }
+    line_ticks += ticks;
+    summary.ticks += ticks;
+}
+
+/**
+  * @brief  Prepares step segments of the planned blocks and takes them all, as the stepper
+            interrupt would execute them. Planner blocks completely prepared are discarded.
+  * @param  None
+  * @retval true if any segment was taken, false if the segment preparation is stalled
+  */
+static uint8_t _take_segments(void) {
+    uint64_t ticks;
+    uint8_t block_start;
+    uint8_t taken = false;
+    /* */
+    stepper_prep_buffer();
+    while (stepper_simulate_segment(&ticks, &block_start)) {
+        if (block_start) {
+            exec_line = block_line[block_tail];
+            if (++block_tail == BLOCK_BUFFER_SIZE) { block_tail = 0; }
+        }
+        _add_time(exec_line, ticks);
+        taken = true;
+    }
+    return(taken);
+}
+#endif
+
+/* Exported Functions --------------------------------------------------------*/
+
+/**
+  * @brief  Drops the validation in progress. Called upon system reset, which restores the
+            parser state itself.
+  * @param  None
+  * @retval None
+  */
+void validation_reset(void) {
+    active = false;
+}
+
+/**
+  * @brief  Tells if a validation is in progress.
+  * @param  None
+  * @retval true between validation_begin() and validation_end()
+  */
+uint8_t validation_active(void) {
+    return(active);
+}
+
+/**
+  * @brief  Starts a validation, saves the parser state and enters check mode. Must be called in
+            the IDLE state, with the planner empty.
+  * @param  uint8_t mode, VALIDATION_CHECK or VALIDATION_SIMULATE
+  * @retval None
+  */
+void validation_begin(uint8_t mode) {
+    memset(&summary, 0, sizeof(validation_summary_t));
+    #ifdef PROGRAM_SIMULATION
+      simulate = (mode == VALIDATION_SIMULATE);
+      summary.simulated = simulate;
+      block_head = block_tail = 0;
+      exec_line = time_line = 0;
+    #else
+      (void)mode;
+    #endif
+    memcpy(&saved_state, &gc_state, sizeof(parser_state_t));
+    #ifdef PARAMETRIC_GCODE
+      memcpy(saved_parameters, expr_parameters, sizeof(saved_parameters));
+    #endif
+    sys.state = STATE_CHECK_MODE;
+    active = true;
+}
+
+/**
+  * @brief  Counts a validated line, and logs it if failed.
+  * @param  uint8_t status, of the line
+  * @retval None
+  */
+void validation_line(uint8_t status) {
+    summary.lines++;
+    if (status != STATUS_OK) {
+        if (summary.errors < VALIDATION_ERROR_LOG) {
+            summary.error_line[summary.errors] = summary.lines;
+            summary.error_status[summary.errors] = status;
+        }
+        summary.errors++;
+    }
+}
+
+/**
+  * @brief  Checks the target of a line motion. Called from mc_line() in place of the execution.
+  * @param  float *target, machine coordinates
+  * @retval true if the motion is to be planned by validation_plan() for a simulation
+  */
+uint8_t validation_target(float *target) {
+    /* the first motion starts from the position the job is validated from */
+    if (!summary.motion) {
+        summary.motion = true;
+        memcpy(summary.min, saved_state.position, sizeof(summary.min));
+        memcpy(summary.max, saved_state.position, sizeof(summary.max));
+    }
+    _extend(target);
+    /* counted where a run would stop with a soft limit alarm */
+    if (bit_istrue(settings.flags, BITFLAG_SOFT_LIMIT_ENABLE) && system_check_travel_limits(target)) {
+        if (summary.soft_limit_count == 0) { summary.soft_limit_line = summary.lines + 1; }
+        summary.soft_limit_count++;
+    }
+    #ifdef PROGRAM_SIMULATION
+      return(simulate);
+    #else
+      return(false);
+    #endif
+}
+
+#ifdef PROGRAM_SIMULATION
+/**
+  * @brief  Plans a line motion of a simulation. Takes the step segments of planned blocks while
+            the planner buffer is full, as the stepper interrupt would make room during a run.
+            Called from mc_line() in place of the soft limit check and the wait for the planner.
+  * @param  float *target, machine coordinates, plan_line_data_t *pl_data
+  * @retval None
+  */
+void validation_plan(float *target, plan_line_data_t *pl_data) {
+    while (plan_check_full_buffer()) {
+        if (!_take_segments()) { return; }
+    }
+    if (plan_buffer_line(target, pl_data) != PLAN_EMPTY_BLOCK) {
+        block_line[block_head] = summary.lines + 1;
+        if (++block_head == BLOCK_BUFFER_SIZE) { block_head = 0; }
+    }
+}
+
+/**
+  * @brief  Takes the step segments of all planned blocks, the run comes to a stop. Called from
+            protocol_buffer_synchronize() during a validation.
+  * @param  None
+  * @retval None
+  */
+void validation_synchronize(void) {
+    while (plan_get_current_block() != NULL) {
+        if (!_take_segments()) { return; }
+    }
+}
+
+/**
+  * @brief  Adds a dwell to the run time of a simulation. Called from mc_dwell().
+  * @param  float seconds
+  * @retval None
+  */
+void validation_dwell(float seconds) {
+    if (!simulate) { return; }
+    validation_synchronize();
+    _add_time(summary.lines + 1, (uint64_t)(seconds*VALIDATION_TICKS_PER_SECOND));
+}
+#endif
+
+/**
+  * @brief  Ends a validation, reports its summary, restores the parser state and leaves check
+            mode.
+  * @param  None
+  * @retval None
+  */
+void validation_end(void) {
+    #ifdef PROGRAM_SIMULATION
+      if (simulate) {
+          validation_synchronize();
+          if (time_line != 0) { report_simulation_line(time_line, line_ticks); }
+          /* the planner position is back at the machine position, the segment preparation and
+             step control are left as a reset leaves them */
+          plan_reset();
+          plan_sync_position();
+          stepper_reset();
+          sys.step_control = STEP_CONTROL_NORMAL_OP;
+      }
+    #endif
+    report_validation_summary(&summary);
+    memcpy(&gc_state, &saved_state, sizeof(parser_state_t));
+    #ifdef PARAMETRIC_GCODE
+      memcpy(expr_parameters, saved_parameters, sizeof(saved_parameters));
+    #endif
+    #ifdef OWORD_SUBROUTINES
+      oword_reset(); // A subroutine or loop left open by the job
+    #endif
+    sys.state = STATE_IDLE;
+    active = false;
+}
+
+#endif  /* PROGRAM_VALIDATION */
+
+/******************************************************************************
+      END FILE
+******************************************************************************/
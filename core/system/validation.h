@@ -0,0 +1,80 @@
+/**
+  ******************************************************************************
+  * @file    validation.h
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Validation of whole jobs in check mode, summarized in one report instead of a
+             response per line.
+  ******************************************************************************
+**/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __GRBL_VALIDATION_H
+#define __GRBL_VALIDATION_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "config.h"
+#include "nuts_bolts.h"
+#ifdef PROGRAM_SIMULATION
+  #include "planner.h"
+#endif
+
+/* Exported define -----------------------------------------------------------*/
+/* A validation runs the lines of a job in check mode. The parser state is saved upon
+   validation_begin() and restored upon validation_end(), so the job validated leaves no modes,
+   offsets or parameters behind. Motions are not planned, their machine targets only extend the
+   extents of the job and are checked against the soft limits, when enabled, without an alarm.
+   Lines are counted from 1, a failing line is logged with its status code and the validation
+   goes on with the next line.
+   A simulation (PROGRAM_SIMULATION) also plans the motions and prepares their step segments, as
+   a run would with the overrides in effect. The segments are taken from the segment buffer in
+   place of the stepper interrupt, each taking n_step*cycles_per_tick ticks of the stepper timer,
+   which add up to the run time of the line the planner block comes from. Dwells add their time.
+   The planner is reset afterwards. */
+#define VALIDATION_CHECK              0   // validation_begin() modes
+#define VALIDATION_SIMULATE           1
+#ifndef VALIDATION_ERROR_LOG
+  #define VALIDATION_ERROR_LOG        8   // (1-255) Failing lines reported by line and status
+#endif
+#define VALIDATION_REALTIME_LINES     16  // Lines of a stored program parsed per realtime check
+#define VALIDATION_TICKS_PER_SECOND   (TICKS_PER_MICROSECOND*1000000UL) // Stepper timer clock
+
+/* Exported macro ------------------------------------------------------------*/
+/* Exported typedef ----------------------------------------------------------*/
+typedef struct {
+    uint32_t lines;                               // Lines validated
+    uint32_t errors;                              // Failing lines
+    uint32_t error_line[VALIDATION_ERROR_LOG];    // First failing lines
+    uint8_t error_status[VALIDATION_ERROR_LOG];   // and their status codes
+    uint32_t soft_limit_count;                    // Motions beyond the soft limits
+    uint32_t soft_limit_line;                     // Line of the first one
+    uint8_t motion;                               // Extents are set, the job has motions
+    float min[N_AXIS];                            // Extents in machine coordinates, mm
+    float max[N_AXIS];
+    #ifdef PROGRAM_SIMULATION
+      uint8_t simulated;                          // Run time is set
+      uint64_t ticks;                             // Run time in stepper timer ticks
+    #endif
+} validation_summary_t;
+
+/* Exported variables --------------------------------------------------------*/
+/* Exported function ---------------------------------------------------------*/
+extern void validation_reset(void);
+extern uint8_t validation_active(void);
+extern void validation_begin(uint8_t mode);
+extern void validation_line(uint8_t status);
+extern uint8_t validation_target(float *target);
+extern void validation_end(void);
+#ifdef PROGRAM_SIMULATION
+  extern void validation_plan(float *target, plan_line_data_t *pl_data);
+  extern void validation_synchronize(void);
+  extern void validation_dwell(float seconds);
+#endif
+
+
+#endif /* __GRBL_VALIDATION_H */
+/******************************************************************************
+      END FILE
+******************************************************************************/
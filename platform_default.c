@@ -81,9 +81,16 @@ uint8_t ngrbl_hal_probe_get_state(void) { return 0; }
 uint8_t ngrbl_hal_eeprom_read_byte(uint16_t addr) { return 0; }
 void ngrbl_hal_eeprom_write_byte(uint16_t addr, uint8_t new_value) { /* */ }
 
+/* STORAGE -------------------------------------------------------------------*/
+uint32_t ngrbl_hal_storage_get_block_count(void) { return 0; }
+void ngrbl_hal_storage_read_block(uint32_t block, uint8_t *data) { ngrbl_hal_storage_read_callback(0); }
+uint8_t ngrbl_hal_storage_write_block(uint32_t block, const uint8_t *data) { return 0; }
+
 /* SERIAL --------------------------------------------------------------------*/
 void ngrbl_hal_serail_init(uint32_t baudrate) { /* */ }
 void ngrbl_hal_serial_write_byte(uint8_t data) { /* */ }
+void ngrbl_hal_serial_write(uint8_t *data, uint16_t length) { ngrbl_hal_serial_tx_callback(); }
+void ngrbl_hal_serial_channel_write(uint8_t channel, uint8_t *data, uint16_t length) { ngrbl_hal_serial_channel_tx_callback(channel); }
 void ngrbl_hal_serail_stop_tx(void) { /* */ }
 
 /* UTILS ---------------------------------------------------------------------*/
@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    platform_storage_file.c
+  * @author
+  * @version 1.0.0
+  * @date
+  * @brief   Block storage of the NGRBL library kept in a local file, for host builds running
+  *          the program store (PROGRAM_STORE) on Linux.
+  *			 NOTE: THIS FILE IS NOT A PART OF NGRBL, IT MAY USE ONLY FOR TARGET
+  ******************************************************************************
+**/
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include "hal_abstract.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#ifndef NGRBL_STORAGE_FILE
+  #define NGRBL_STORAGE_FILE          "ngrbl_storage.bin"
+#endif
+#ifndef NGRBL_STORAGE_BLOCK_COUNT
+  #define NGRBL_STORAGE_BLOCK_COUNT   1024
+#endif
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static FILE *storage;
+
+/* Private function prototypes -----------------------------------------------*/
+/* Extern function -----------------------------------------------------------*/
+/* Functions -----------------------------------------------------------------*/
+
+/**
+  * @brief  Opens the storage file, creating it upon first use.
+  * @param  None
+  * @retval FILE *, NULL if it could not be opened
+  */
+static FILE *storage_file(void) {
+    if (storage == NULL) {
+        storage = fopen(NGRBL_STORAGE_FILE, "r+b");
+        if (storage == NULL) { storage = fopen(NGRBL_STORAGE_FILE, "w+b"); }
+    }
+    return storage;
+}
+
+/* STORAGE -------------------------------------------------------------------*/
+uint32_t ngrbl_hal_storage_get_block_count(void) {
+    return (storage_file() != NULL) ? NGRBL_STORAGE_BLOCK_COUNT : 0;
+}
+
+/* Reads are synchronous, completed before returning. Blocks beyond the end of the file read as
+   erased */
+void ngrbl_hal_storage_read_block(uint32_t block, uint8_t *data) {
+    uint8_t success = 0;
+    memset(data, 0xFF, NGRBL_HAL_STORAGE_BLOCK_SIZE);
+    if ((storage_file() != NULL) &&
+        (fseek(storage, (long)block*NGRBL_HAL_STORAGE_BLOCK_SIZE, SEEK_SET) == 0)) {
+        size_t length = fread(data, 1, NGRBL_HAL_STORAGE_BLOCK_SIZE, storage);
+        success = (length == NGRBL_HAL_STORAGE_BLOCK_SIZE) || !ferror(storage);
+        clearerr(storage);
+    }
+    ngrbl_hal_storage_read_callback(success);
+}
+
+uint8_t ngrbl_hal_storage_write_block(uint32_t block, const uint8_t *data) {
+    if ((block >= NGRBL_STORAGE_BLOCK_COUNT) || (storage_file() == NULL)) { return 0; }
+    if (fseek(storage, (long)block*NGRBL_HAL_STORAGE_BLOCK_SIZE, SEEK_SET) != 0) { return 0; }
+    if (fwrite(data, 1, NGRBL_HAL_STORAGE_BLOCK_SIZE, storage) != NGRBL_HAL_STORAGE_BLOCK_SIZE) { return 0; }
+    return (fflush(storage) == 0);
+}
+
+
+/******************************************************************************
+      END FILE
+******************************************************************************/